@@ -0,0 +1,33 @@
+#include "bench_support.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Replaces the global allocation functions of the benchmark binary so that
+// every benchmark can report its allocations per iteration.
+
+namespace {
+
+std::atomic<std::uint64_t> allocation_count{0};
+
+}
+
+std::uint64_t simparse_bench::allocations() noexcept {
+    return allocation_count.load(std::memory_order_relaxed);
+}
+
+void* operator new(std::size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+
+namespace simparse_bench {
+
+/// The number of heap allocations made so far by the process (see alloc_counter.cc).
+std::uint64_t allocations() noexcept;
+
+/// The largest generated input: SIMPARSE_BENCH_MAX_BYTES, or 1 MiB when unset.
+/// Set it to 1073741824 to run the sweep up to 1 GiB.
+inline std::int64_t max_input_bytes() {
+    if (const char* env = std::getenv("SIMPARSE_BENCH_MAX_BYTES")) {
+        return std::strtoll(env, nullptr, 10);
+    }
+    return std::int64_t{1} << 20;
+}
+
+/// Registers input sizes from 1 KiB to max_input_bytes(), 32 times larger each step.
+inline void input_sizes(benchmark::internal::Benchmark* b) {
+    auto max = max_input_bytes();
+    for (std::int64_t bytes = std::int64_t{1} << 10; bytes <= max; bytes *= 32) {
+        b->Arg(bytes);
+    }
+}
+
+/// `unit` repeated to fill at least one unit and at most `bytes` bytes.
+inline std::string repeat_to(std::string_view unit, std::size_t bytes) {
+    auto count = bytes > unit.size() ? bytes / unit.size() : 1;
+    std::string text;
+    text.reserve(count * unit.size());
+    text.append(unit);
+    while (text.size() < count * unit.size()) {
+        text.append(text.data(), std::min(text.size(), count * unit.size() - text.size()));
+    }
+    return text;
+}
+
+/// Runs `body` on every iteration and reports bytes/sec and allocations per iteration.
+template<typename Body>
+void measure(benchmark::State& state, const std::string& text, Body body) {
+    auto before = allocations();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(body(text));
+    }
+    auto allocs = static_cast<double>(allocations() - before);
+    state.counters["allocs"] = benchmark::Counter(allocs, benchmark::Counter::kAvgIterations);
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+
+}
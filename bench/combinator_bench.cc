@@ -0,0 +1,164 @@
+#include "bench_support.hpp"
+#include "simparse.hpp"
+#include "simparse/sax.hpp"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cctype>
+#include <limits>
+#include <string>
+
+namespace {
+
+using simparse_bench::measure;
+using simparse_bench::repeat_to;
+
+/// Parses `element` and skips `separator` until the input ends or `element` fails.
+template<typename P, typename Q>
+std::size_t parse_each(const P& element, const Q& separator, const std::string& text) {
+    const char* it = text.data();
+    const char* end = it + text.size();
+    std::size_t count = 0;
+    while (it != end) {
+        auto r = simparse::try_parse(element, it, end);
+        if (!r) {
+            break;
+        }
+        benchmark::DoNotOptimize(*r);
+        simparse::try_skip(separator, it, end);
+        ++count;
+    }
+    return count;
+}
+
+const auto blanks = simparse::many(simparse::whitespace);
+
+void BM_Satisfy(benchmark::State& state) {
+    auto text = repeat_to("0123456789", state.range(0));
+    auto digit = simparse::satisfy([](char c) { return std::isdigit(static_cast<unsigned char>(c)) != 0; });
+    measure(state, text, [&](const std::string& t) { return parse_each(digit, blanks, t); });
+}
+
+void BM_Rep(benchmark::State& state) {
+    auto text = repeat_to("01234567 ", state.range(0));
+    auto block = simparse::rep(8, simparse::digit);
+    measure(state, text, [&](const std::string& t) { return parse_each(block, blanks, t); });
+}
+
+void BM_ManyClass(benchmark::State& state) {
+    auto text = repeat_to("word1234 ", state.range(0));
+    auto word = simparse::many(simparse::alphanumeric);
+    measure(state, text, [&](const std::string& t) { return parse_each(word, blanks, t); });
+}
+
+void BM_ManyGeneric(benchmark::State& state) {
+    auto text = repeat_to("word1234 ", state.range(0));
+    auto word = simparse::many(simparse::satisfy([](char c) { return std::isalnum(static_cast<unsigned char>(c)) != 0; }));
+    measure(state, text, [&](const std::string& t) { return parse_each(word, blanks, t); });
+}
+
+void BM_String(benchmark::State& state) {
+    auto text = repeat_to("ZONE ", state.range(0));
+    auto keyword = simparse::string("ZONE");
+    measure(state, text, [&](const std::string& t) { return parse_each(keyword, blanks, t); });
+}
+
+void BM_Back(benchmark::State& state) {
+    // The first branch matches "VAR" and fails at the blank, so every element rewinds.
+    auto text = repeat_to("VAR ", state.range(0));
+    auto keyword = simparse::back(simparse::string("VARIABLES")) | simparse::string("VAR");
+    measure(state, text, [&](const std::string& t) { return parse_each(keyword, blanks, t); });
+}
+
+void BM_Peek(benchmark::State& state) {
+    auto text = repeat_to("123456 ", state.range(0));
+    auto number = simparse::ignore(simparse::peek(simparse::digit)) + simparse::many(simparse::digit);
+    measure(state, text, [&](const std::string& t) { return parse_each(number, blanks, t); });
+}
+
+void BM_Sequence(benchmark::State& state) {
+    auto text = repeat_to("key=123 ", state.range(0));
+    auto pair = simparse::many(simparse::alphabet) + simparse::string("=") + simparse::many(simparse::digit);
+    measure(state, text, [&](const std::string& t) { return parse_each(pair, blanks, t); });
+}
+
+void BM_Choice(benchmark::State& state) {
+    auto text = repeat_to("I=1 J=22 K=333 ", state.range(0));
+    auto label = simparse::string("I") | simparse::string("J") | simparse::string("K");
+    auto pair = label + simparse::string("=") + simparse::many(simparse::digit);
+    measure(state, text, [&](const std::string& t) { return parse_each(pair, blanks, t); });
+}
+
+void BM_Alt(benchmark::State& state) {
+    auto text = repeat_to("I=1 J=22 K=333 ", state.range(0));
+    auto label = simparse::alt(simparse::string("I"), simparse::string("J"), simparse::string("K"));
+    auto pair = label + simparse::string("=") + simparse::many(simparse::digit);
+    measure(state, text, [&](const std::string& t) { return parse_each(pair, blanks, t); });
+}
+
+/// The VARIABLES header of ParseTests.ExampleTest, end to end.
+void BM_Variables(benchmark::State& state) {
+    auto text = "VARIABLES= " + repeat_to("\"x\" , \"rho\", \"u\" ,\"v\" , \"pressure\" , ", state.range(0));
+    auto label = simparse::back(
+        simparse::string("VARIABLES")
+        + simparse::many(simparse::whitespace)
+        + simparse::string("=")
+        + simparse::many(simparse::whitespace)
+    );
+    auto item = simparse::back(
+        simparse::ignore(simparse::string("\""))
+        + simparse::many(simparse::alphanumeric)
+        + simparse::ignore(simparse::string("\""))
+        + simparse::ignore(
+            simparse::many(simparse::whitespace)
+            + simparse::many(simparse::string(","))
+            + simparse::many(simparse::whitespace)
+        )
+    );
+    measure(state, text, [&](const std::string& t) {
+        auto it = t.cbegin();
+        std::size_t count = 0;
+        if (simparse::try_parse(label, it, t.cend())) {
+            while (simparse::try_parse(item, it, t.cend())) {
+                ++count;
+            }
+        }
+        return count;
+    });
+}
+
+struct min_max {
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+
+    void on_value(double v) {
+        min = std::min(min, v);
+        max = std::max(max, v);
+    }
+};
+
+/// A reduction over the values of a data block through the event parsers.
+void BM_SaxMinMax(benchmark::State& state) {
+    auto text = repeat_to("1.25e-3 -4.5 300.0 0.125\n", state.range(0));
+    min_max handler;
+    auto values = simparse::many(simparse::sax::value(handler) + simparse::ignore(simparse::many(simparse::whitespace)));
+    measure(state, text, [&](const std::string& t) {
+        const char* it = t.data();
+        simparse::try_skip(values, it, t.data() + t.size());
+        return handler.max;
+    });
+}
+
+}
+
+BENCHMARK(BM_Satisfy)->Apply(simparse_bench::input_sizes);
+BENCHMARK(BM_Rep)->Apply(simparse_bench::input_sizes);
+BENCHMARK(BM_ManyClass)->Apply(simparse_bench::input_sizes);
+BENCHMARK(BM_ManyGeneric)->Apply(simparse_bench::input_sizes);
+BENCHMARK(BM_String)->Apply(simparse_bench::input_sizes);
+BENCHMARK(BM_Back)->Apply(simparse_bench::input_sizes);
+BENCHMARK(BM_Peek)->Apply(simparse_bench::input_sizes);
+BENCHMARK(BM_Sequence)->Apply(simparse_bench::input_sizes);
+BENCHMARK(BM_Choice)->Apply(simparse_bench::input_sizes);
+BENCHMARK(BM_Alt)->Apply(simparse_bench::input_sizes);
+BENCHMARK(BM_Variables)->Apply(simparse_bench::input_sizes);
+BENCHMARK(BM_SaxMinMax)->Apply(simparse_bench::input_sizes);
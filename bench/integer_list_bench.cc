@@ -0,0 +1,73 @@
+#include "simparse/numeric.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+/// Whitespace-separated node indices, as in a finite-element connectivity list.
+std::string make_connectivity(std::size_t count) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<std::int32_t> node(1, 50'000'000);
+    std::string text;
+    for (std::size_t i = 0; i < count; ++i) {
+        text += std::to_string(node(rng));
+        text += (i % 8 == 7) ? '\n' : ' ';
+    }
+    return text;
+}
+
+void BM_IntegerList(benchmark::State& state) {
+    auto count = static_cast<std::size_t>(state.range(0));
+    auto text = make_connectivity(count);
+    std::vector<std::int32_t> nodes(count);
+    auto parser = simparse::integer_list(std::span<std::int32_t>(nodes));
+    for (auto _ : state) {
+        auto it = text.cbegin();
+        benchmark::DoNotOptimize(parser(it, text.cend()));
+        benchmark::DoNotOptimize(nodes.data());
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+
+void BM_IntegerCombinator(benchmark::State& state) {
+    auto count = static_cast<std::size_t>(state.range(0));
+    auto text = make_connectivity(count);
+    std::vector<std::int32_t> nodes(count);
+    auto blanks = simparse::ignore(simparse::many(simparse::whitespace));
+    auto value = simparse::integer<std::int32_t>();
+    for (auto _ : state) {
+        auto it = text.cbegin();
+        for (auto& n : nodes) {
+            blanks(it, text.cend());
+            n = value(it, text.cend());
+        }
+        benchmark::DoNotOptimize(nodes.data());
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+
+void BM_DigitStoi(benchmark::State& state) {
+    auto count = static_cast<std::size_t>(state.range(0));
+    auto text = make_connectivity(count);
+    std::vector<std::int32_t> nodes(count);
+    auto blanks = simparse::ignore(simparse::many(simparse::whitespace));
+    auto digits = simparse::many(simparse::digit);
+    for (auto _ : state) {
+        auto it = text.cbegin();
+        for (auto& n : nodes) {
+            blanks(it, text.cend());
+            n = std::stoi(digits(it, text.cend()));
+        }
+        benchmark::DoNotOptimize(nodes.data());
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+
+}
+
+BENCHMARK(BM_IntegerList)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_IntegerCombinator)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_DigitStoi)->Range(1 << 10, 1 << 20);
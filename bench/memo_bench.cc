@@ -0,0 +1,73 @@
+#include "simparse.hpp"
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <string>
+
+namespace {
+
+/// Level D of a deliberately ambiguous grammar:
+///   P(0) = "x",  P(D) = back(P(D-1) "a") | P(D-1) "b".
+/// On "xbb...b" each level runs P(D-1) twice at the same position, so the
+/// plain grammar takes 2^D steps; memoized, it takes D.
+template<bool Memo, int D>
+const auto& level() {
+    if constexpr (D == 0) {
+        static const auto p = simparse::string("x");
+        return p;
+    } else {
+        static const auto inner = simparse::make_parser([]<simparse::CharIterator I, simparse::CharSentinel<I> S>(I& str_iter, S end) {
+            static const auto p = [] {
+                const auto& lower = level<Memo, D - 1>();
+                return simparse::back(lower + simparse::string("a")) | (lower + simparse::string("b"));
+            }();
+            return simparse::try_parse(p, str_iter, end);
+        });
+        if constexpr (Memo) {
+            static const auto p = simparse::memo(inner);
+            return p;
+        } else {
+            return inner;
+        }
+    }
+}
+
+template<bool Memo, int D>
+void run_ambiguous(benchmark::State& state) {
+    std::string text(D + 1, 'b');
+    text[0] = 'x';
+    const auto& parser = level<Memo, D>();
+    for (auto _ : state) {
+        simparse::memo_scope scope;
+        auto it = text.cbegin();
+        benchmark::DoNotOptimize(parser(it, text.cend()));
+    }
+    state.SetComplexityN(D);
+}
+
+/// The depth is the argument, so the runs of one mode form a single family
+/// whose growth Complexity() can fit.
+template<bool Memo>
+void BM_Ambiguous(benchmark::State& state) {
+    switch (state.range(0)) {
+    case 4: return run_ambiguous<Memo, 4>(state);
+    case 8: return run_ambiguous<Memo, 8>(state);
+    case 12: return run_ambiguous<Memo, 12>(state);
+    case 16: return run_ambiguous<Memo, 16>(state);
+    case 64:
+        if constexpr (Memo) {
+            return run_ambiguous<Memo, 64>(state);
+        }
+        [[fallthrough]];
+    default:
+        state.SkipWithError("Unsupported depth.");
+    }
+}
+
+double exponential(benchmark::IterationCount d) {
+    return std::exp2(static_cast<double>(d));
+}
+
+}
+
+BENCHMARK_TEMPLATE(BM_Ambiguous, false)->DenseRange(4, 16, 4)->Complexity(exponential);
+BENCHMARK_TEMPLATE(BM_Ambiguous, true)->DenseRange(4, 16, 4)->Arg(64)->Complexity(benchmark::oN);
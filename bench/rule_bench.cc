@@ -0,0 +1,67 @@
+#include "simparse.hpp"
+#include "simparse/trace.hpp"
+#include <benchmark/benchmark.h>
+#include <string>
+
+namespace {
+
+using iterator = std::string::const_iterator;
+
+/// One short token parsed directly: the baseline for a rule boundary.
+void BM_TokenDirect(benchmark::State& state) {
+    std::string text = "12345";
+    auto token = simparse::view(simparse::many(simparse::digit));
+    for (auto _ : state) {
+        auto it = text.cbegin();
+        benchmark::DoNotOptimize(simparse::try_parse(token, it, text.cend()));
+    }
+}
+
+/// The same token behind one rule boundary.
+void BM_TokenRule(benchmark::State& state) {
+    std::string text = "12345";
+    simparse::rule<iterator, std::string_view, iterator> token = simparse::view(simparse::many(simparse::digit));
+    for (auto _ : state) {
+        auto it = text.cbegin();
+        benchmark::DoNotOptimize(simparse::try_parse(token, it, text.cend()));
+    }
+}
+
+/// The same token behind a named rule, with tracing off and on. Without
+/// SIMPARSE_TRACE no span is compiled in and both variants match BM_TokenRule.
+void BM_TokenNamedRule(benchmark::State& state) {
+    std::string text = "12345";
+    simparse::rule<iterator, std::string_view, iterator> token("token");
+    token = simparse::view(simparse::many(simparse::digit));
+    if (state.range(0)) {
+        simparse::start_tracing();
+    }
+    for (auto _ : state) {
+        auto it = text.cbegin();
+        benchmark::DoNotOptimize(simparse::try_parse(token, it, text.cend()));
+    }
+    simparse::stop_tracing();
+    simparse::clear_trace();
+}
+
+/// Parenthesised nesting: every level crosses the rule boundary once.
+void BM_NestedRule(benchmark::State& state) {
+    auto depth = static_cast<std::size_t>(state.range(0));
+    auto text = std::string(depth, '(') + "1" + std::string(depth, ')');
+    simparse::rule<iterator, std::string_view, iterator> group;
+    group = simparse::view(
+        simparse::back(simparse::string("(") + group + simparse::string(")"))
+        | simparse::many(simparse::digit));
+    for (auto _ : state) {
+        auto it = text.cbegin();
+        benchmark::DoNotOptimize(simparse::try_skip(group, it, text.cend()));
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * depth));
+}
+
+}
+
+BENCHMARK(BM_TokenDirect);
+BENCHMARK(BM_TokenRule);
+BENCHMARK(BM_TokenNamedRule)->Arg(0)->Arg(1);
+BENCHMARK(BM_NestedRule)->Range(8, 1 << 10);
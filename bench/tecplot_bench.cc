@@ -0,0 +1,50 @@
+#include "bench_support.hpp"
+#include "simparse/numeric.hpp"
+#include "simparse/parallel.hpp"
+#include "simparse/tecplot_corpus.hpp"
+#include <benchmark/benchmark.h>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace {
+
+/// A POINT zone of about `bytes` bytes with scientific values.
+simparse::tecplot_options corpus_of(std::size_t bytes) {
+    simparse::tecplot_options options;
+    options.variables = 5;
+    // "-1.234567e+02 " is 14 bytes per value.
+    options.i = std::max<std::size_t>(1, bytes / (options.variables * 14));
+    return options;
+}
+
+/// The offset of the first value of the first zone.
+std::size_t data_offset(const std::string& text) {
+    return text.find('\n', text.find("ZONE")) + 1;
+}
+
+void BM_TecplotValuesInto(benchmark::State& state) {
+    auto options = corpus_of(state.range(0));
+    auto text = simparse::make_tecplot(options);
+    std::vector<double> values(options.variables * options.i);
+    auto parser = simparse::values_into(std::span<double>(values));
+    auto offset = data_offset(text);
+    simparse_bench::measure(state, text, [&](const std::string& t) {
+        const char* it = t.data() + offset;
+        return parser(it, t.data() + t.size());
+    });
+}
+
+void BM_TecplotParallel(benchmark::State& state) {
+    auto text = simparse::make_tecplot(corpus_of(state.range(0)));
+    auto offset = data_offset(text);
+    simparse_bench::measure(state, text, [&](const std::string& t) {
+        const char* it = t.data() + offset;
+        return simparse::parallel_many(it, t.data() + t.size(), simparse::real<double>())->size();
+    });
+}
+
+}
+
+BENCHMARK(BM_TecplotValuesInto)->Apply(simparse_bench::input_sizes);
+BENCHMARK(BM_TecplotParallel)->Apply(simparse_bench::input_sizes)->UseRealTime();
@@ -0,0 +1,141 @@
+#include "simparse.hpp"
+#include "simparse/vm.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <string>
+
+namespace {
+
+namespace vm = simparse::vm;
+
+/// The `VARIABLES=` header of ParseTests.ExampleTest with `count` names.
+std::string make_variables(std::size_t count) {
+    std::string text = "VARIABLES= ";
+    for (std::size_t i = 0; i < count; ++i) {
+        text += "\"var" + std::to_string(i) + "\" , ";
+    }
+    return text;
+}
+
+/// The `I = 1, J = 2, K = 3` labels of ParseTests.ExampleTest2, repeated.
+std::string make_labels(std::size_t count) {
+    std::string text;
+    for (std::size_t i = 0; i < count; ++i) {
+        text += "I = " + std::to_string(i) + ", J = 2, K = 3, ";
+    }
+    return text;
+}
+
+/// Parses the header, then items until one fails.
+template<typename L, typename P>
+std::size_t parse_all(const L& label, const P& item, const std::string& text) {
+    auto it = text.cbegin();
+    std::size_t count = 0;
+    if (simparse::try_parse(label, it, text.cend())) {
+        while (simparse::try_parse(item, it, text.cend())) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+/// Parses label/value pairs until one fails.
+template<typename L, typename P>
+std::size_t parse_pairs(const L& label, const P& entry, const std::string& text) {
+    auto it = text.cbegin();
+    std::size_t count = 0;
+    while (simparse::try_parse(label, it, text.cend()) && simparse::try_parse(entry, it, text.cend())) {
+        ++count;
+    }
+    return count;
+}
+
+void BM_ExampleTemplate(benchmark::State& state) {
+    auto text = make_variables(static_cast<std::size_t>(state.range(0)));
+    auto label = simparse::back(
+        simparse::string("VARIABLES")
+        + simparse::many(simparse::whitespace)
+        + simparse::string("=")
+        + simparse::many(simparse::whitespace)
+    );
+    auto item = simparse::back(
+        simparse::ignore(simparse::string("\""))
+        + simparse::many(simparse::alphanumeric)
+        + simparse::ignore(simparse::string("\""))
+        + simparse::ignore(
+            simparse::many(simparse::whitespace)
+            + simparse::many(simparse::string(","))
+            + simparse::many(simparse::whitespace)
+        )
+    );
+    std::size_t items = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(items = parse_all(label, item, text));
+    }
+    state.counters["items"] = static_cast<double>(items);
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+
+void BM_ExampleVm(benchmark::State& state) {
+    auto text = make_variables(static_cast<std::size_t>(state.range(0)));
+    auto ws = vm::many(vm::cls(simparse::whitespace.cls));
+    auto label = vm::parser(vm::compile(vm::lit("VARIABLES") + ws + vm::lit("=") + ws));
+    auto item = vm::parser(vm::compile(
+        vm::lit("\"") + vm::capture(vm::many(vm::cls(simparse::alphanumeric.cls))) + vm::lit("\"")
+        + ws + vm::many(vm::lit(",")) + ws));
+    std::size_t items = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(items = parse_all(label, item, text));
+    }
+    state.counters["items"] = static_cast<double>(items);
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+
+void BM_Example2Template(benchmark::State& state) {
+    auto text = make_labels(static_cast<std::size_t>(state.range(0)));
+    auto label = simparse::ignore(simparse::many(simparse::whitespace))
+        + simparse::many(simparse::alphabet)
+        + simparse::ignore(
+            simparse::many(simparse::whitespace)
+            + simparse::string("=")
+            + simparse::many(simparse::whitespace)
+        );
+    auto entry = simparse::back(
+        simparse::ignore(simparse::many(simparse::string("\"")))
+        + simparse::many(simparse::alphanumeric | simparse::whitespace)
+        + simparse::ignore(
+            simparse::many(simparse::string("\""))
+            + simparse::many(simparse::string(","))
+        )
+    );
+    std::size_t items = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(items = parse_pairs(label, entry, text));
+    }
+    state.counters["items"] = static_cast<double>(items);
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+
+void BM_Example2Vm(benchmark::State& state) {
+    auto text = make_labels(static_cast<std::size_t>(state.range(0)));
+    auto ws = vm::many(vm::cls(simparse::whitespace.cls));
+    auto label = vm::parser(vm::compile(
+        ws + vm::capture(vm::many(vm::cls(simparse::alphabet.cls))) + ws + vm::lit("=") + ws));
+    auto entry = vm::parser(vm::compile(
+        vm::many(vm::lit("\""))
+        + vm::capture(vm::many(vm::cls(simparse::alphanumeric.cls | simparse::whitespace.cls)))
+        + vm::many(vm::lit("\"")) + vm::many(vm::lit(","))));
+    std::size_t items = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(items = parse_pairs(label, entry, text));
+    }
+    state.counters["items"] = static_cast<double>(items);
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+
+}
+
+BENCHMARK(BM_ExampleTemplate)->Range(1 << 6, 1 << 14);
+BENCHMARK(BM_ExampleVm)->Range(1 << 6, 1 << 14);
+BENCHMARK(BM_Example2Template)->Range(1 << 6, 1 << 14);
+BENCHMARK(BM_Example2Vm)->Range(1 << 6, 1 << 14);
@@ -1,6 +1,71 @@
+#pragma once
+
+#include <algorithm>
+#include <any>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <initializer_list>
 #include <iostream>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <cstring>
 #include <iterator>
+#include <map>
+#include <memory>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/// Aligned SIMD loads may read past the end of a null-terminated buffer
+/// (never across a page); such functions are excluded from AddressSanitizer.
+#if defined(__GNUC__)
+#define SIMPARSE_NO_SANITIZE_ADDRESS __attribute__((no_sanitize("address")))
+#else
+#define SIMPARSE_NO_SANITIZE_ADDRESS
+#endif
+
+/// Whether the throwing interface (`operator()`) raises exceptions. Defaults to
+/// whether the compiler has them enabled. Without them, failures propagate as
+/// parse_result through `try_parse` and `try_skip`, and a failing `operator()`
+/// prints the error and aborts.
+#if !defined(SIMPARSE_EXCEPTIONS)
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
+#define SIMPARSE_EXCEPTIONS 1
+#else
+#define SIMPARSE_EXCEPTIONS 0
+#endif
+#endif
+
+/// Records the spans of named rules, the bulk numeric parsers and `parallel_many`
+/// (see `simparse/trace.hpp`). Off by default: the tracer is then not included
+/// and SIMPARSE_TRACE_SPAN compiles to nothing. Templates change with it, so all
+/// translation units of a program must agree on it (the CMake option sets it globally).
+#if !defined(SIMPARSE_TRACE)
+#define SIMPARSE_TRACE 0
+#endif
+
+#if SIMPARSE_TRACE
+#include "simparse/trace.hpp"
+#define SIMPARSE_TRACE_SPAN(var, ...) ::simparse::trace_span var(__VA_ARGS__)
+#else
+#define SIMPARSE_TRACE_SPAN(var, ...) static_cast<void>(0)
+#endif
 
 namespace simparse {
 
@@ -9,35 +74,947 @@ concept CharIterator =
     std::forward_iterator<T> && 
     std::same_as<std::iter_value_t<T>, char>;
 
+/// @brief A sentinel marking the end of the input for the iterator I.
+template<typename S, typename I>
+concept CharSentinel =
+    CharIterator<I> &&
+    std::sentinel_for<S, I>;
+
+/// @brief The default sentinel: the input ends at the first '\0' character.
+/// @note Used when a parser is called with an iterator only. Prefer an explicit
+///       end iterator for buffers that are not null-terminated.
+struct null_sentinel {
+    template<CharIterator I>
+    friend constexpr bool operator==(const I& str_iter, null_sentinel) {
+        return *str_iter == '\0';
+    }
+};
+
+/// @brief A sentinel for buffers that stay readable for `Padding` bytes past the end.
+/// @tparam I The type of the input iterator.
+/// @tparam Padding The number of readable bytes guaranteed after `end`.
+/// @note The caller guarantees the padding, so parsers may read ahead of `end`
+///       (e.g. compare a whole literal at once) and check the bound afterwards.
+template<CharIterator I, std::size_t Padding>
+struct padded_sentinel {
+    static constexpr std::size_t padding = Padding;
+
+    I end;
+
+    friend constexpr bool operator==(const I& str_iter, const padded_sentinel& s) {
+        return str_iter == s.end;
+    }
+};
+
+/// @brief Creates a padded_sentinel for the given end iterator.
+/// @tparam Padding The number of readable bytes guaranteed after `end`.
+/// @param end The end of the input.
+template<std::size_t Padding, CharIterator I>
+constexpr auto padded_end(I end) {
+    return padded_sentinel<I, Padding>{end};
+}
+
+
+/// @brief Describes why a parser failed.
+/// @note The message always points to a string literal, so reporting a failure
+///       never allocates.
+struct parse_error {
+    const char* message;
+    /// @brief Set when the failure happened after a `commit`; alternatives and
+    ///        repetitions propagate it instead of trying something else.
+    bool fatal = false;
+};
+
+/// @brief Thrown by the throwing interface when a committed parser fails.
+struct cut_error : std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+namespace detail {
+
+/// @brief Throws E, or prints its message and aborts when exceptions are disabled.
+template<typename E, typename... Args>
+[[noreturn]] void raise(Args&&... args) {
+#if SIMPARSE_EXCEPTIONS
+    throw E(std::forward<Args>(args)...);
+#else
+    E error(std::forward<Args>(args)...);
+    std::fprintf(stderr, "simparse: %s\n", error.what());
+    std::abort();
+#endif
+}
+
+/// @brief Raises the exception of the throwing interface for a failed parse.
+[[noreturn]] inline void raise_parse_error(const parse_error& error) {
+    if (error.fatal) {
+        raise<cut_error>(error.message);
+    }
+    raise<std::runtime_error>(error.message);
+}
+
+}
+
+/// @brief The outcome of a non-throwing parse: either a value or a parse_error.
+/// @tparam T The type of the parsed value.
+template<typename T>
+class parse_result {
+public:
+    using value_type = T;
+
+    parse_result(T value) : value_(std::move(value)) {}
+    parse_result(parse_error error) : error_(error) {}
+
+    bool has_value() const noexcept { return value_.has_value(); }
+    explicit operator bool() const noexcept { return has_value(); }
+
+    T& operator*() & { return *value_; }
+    const T& operator*() const& { return *value_; }
+    T&& operator*() && { return std::move(*value_); }
+
+    T* operator->() { return &*value_; }
+    const T* operator->() const { return &*value_; }
+
+    const parse_error& error() const noexcept { return error_; }
+
+private:
+    std::optional<T> value_;
+    parse_error error_{nullptr};
+};
+
+/// @brief The outcome of a parse that only recognizes input without producing a value.
+template<>
+class parse_result<void> {
+public:
+    using value_type = void;
+
+    parse_result() = default;
+    parse_result(parse_error error) : error_(error) {}
+
+    bool has_value() const noexcept { return error_.message == nullptr; }
+    explicit operator bool() const noexcept { return has_value(); }
+
+    const parse_error& error() const noexcept { return error_; }
+
+private:
+    parse_error error_{nullptr};
+};
+
+namespace detail {
+
+template<typename T>
+struct is_parse_result : std::false_type {};
+
+template<typename T>
+struct is_parse_result<parse_result<T>> : std::true_type {};
+
+/// @brief The number of `commit`s reached on this thread whose alternative has not ended.
+inline std::size_t& cut_count() {
+    thread_local std::size_t count = 0;
+    return count;
+}
+
+/// @brief Notes the `commit`s reached after it, on behalf of a sequence or an alternative.
+/// @note Only `commit` bumps the count, so a mark costs one load until a parser fails
+///       or an alternative ends.
+class cut_mark {
+public:
+    cut_mark() noexcept : mark_(cut_count()) {}
+
+    bool reached() const noexcept { return cut_count() != mark_; }
+
+    /// @brief Makes a failed result fatal if a commit was reached since the mark.
+    template<typename R>
+    void seal(R& result) const {
+        if (!result && !result.error().fatal && reached()) {
+            result = R(parse_error{result.error().message, true});
+        }
+    }
+
+    /// @brief Ends an alternative: its commits no longer reach the enclosing sequence.
+    void close() const noexcept {
+        if (reached()) {
+            cut_count() = mark_;
+        }
+    }
+
+private:
+    std::size_t mark_;
+};
+
+/// @brief The number of readable bytes past the end guaranteed by the sentinel S.
+template<typename S>
+inline constexpr std::size_t padding_v = 0;
+
+template<typename I, std::size_t Padding>
+inline constexpr std::size_t padding_v<padded_sentinel<I, Padding>> = Padding;
+
+}
+
+/// @brief A set of characters backed by a 256-bit bitmap.
+/// @note All operations are constexpr, so classes combined with `|`, `&` and `~`
+///       are folded into a single bitmap at compile time. Membership does not
+///       depend on the locale.
+class char_class {
+public:
+    constexpr char_class() = default;
+
+    /// @brief Creates a class of the given characters.
+    static constexpr char_class of(std::string_view chars) {
+        char_class result;
+        for (char c : chars) {
+            result.set(static_cast<unsigned char>(c));
+        }
+        return result;
+    }
+
+    /// @brief Creates a class of a single character.
+    static constexpr char_class of(char c) {
+        char_class result;
+        result.set(static_cast<unsigned char>(c));
+        return result;
+    }
+
+    /// @brief Creates a class of the characters in the inclusive range [lo, hi].
+    static constexpr char_class range(char lo, char hi) {
+        char_class result;
+        for (unsigned u = static_cast<unsigned char>(lo); u <= static_cast<unsigned char>(hi); ++u) {
+            result.set(u);
+        }
+        return result;
+    }
+
+    /// @brief Creates a class of every character.
+    static constexpr char_class all() {
+        return ~char_class{};
+    }
+
+    constexpr bool contains(char c) const {
+        auto u = static_cast<unsigned char>(c);
+        return (bits_[u >> 6] >> (u & 63)) & 1;
+    }
+
+    constexpr bool empty() const {
+        return (bits_[0] | bits_[1] | bits_[2] | bits_[3]) == 0;
+    }
+
+    /// @brief Returns the number of members smaller than c.
+    constexpr std::size_t rank(char c) const {
+        auto u = static_cast<unsigned char>(c);
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < (u >> 6); ++i) {
+            count += static_cast<std::size_t>(std::popcount(bits_[i]));
+        }
+        auto below = (std::uint64_t{1} << (u & 63)) - 1;
+        return count + static_cast<std::size_t>(std::popcount(bits_[u >> 6] & below));
+    }
+
+    friend constexpr char_class operator|(const char_class& a, const char_class& b) {
+        char_class result;
+        for (std::size_t i = 0; i < 4; ++i) {
+            result.bits_[i] = a.bits_[i] | b.bits_[i];
+        }
+        return result;
+    }
+
+    friend constexpr char_class operator&(const char_class& a, const char_class& b) {
+        char_class result;
+        for (std::size_t i = 0; i < 4; ++i) {
+            result.bits_[i] = a.bits_[i] & b.bits_[i];
+        }
+        return result;
+    }
+
+    friend constexpr char_class operator~(const char_class& a) {
+        char_class result;
+        for (std::size_t i = 0; i < 4; ++i) {
+            result.bits_[i] = ~a.bits_[i];
+        }
+        return result;
+    }
+
+    /// @brief Returns the members with high nibble `h`, one bit per low nibble.
+    constexpr std::uint16_t row(std::size_t h) const {
+        return static_cast<std::uint16_t>(bits_[h >> 2] >> ((h & 3) * 16));
+    }
+
+    friend constexpr bool operator==(const char_class&, const char_class&) = default;
+
+private:
+    constexpr void set(unsigned u) {
+        bits_[u >> 6] |= std::uint64_t{1} << (u & 63);
+    }
+
+    std::array<std::uint64_t, 4> bits_{};
+};
+
+/// @brief The characters a parser can start with.
+/// @note A nullable parser may succeed without consuming anything, so it is
+///       viable whatever the next character is. Parsers that cannot be
+///       analysed (e.g. `satisfy` with an arbitrary condition) report every
+///       character.
+struct first_set {
+    char_class chars;
+    bool nullable;
+
+    /// @brief The first set of a parser that cannot be analysed.
+    static constexpr first_set unknown() {
+        return {char_class::all(), true};
+    }
+
+    /// @brief Whether a parser with this first set may succeed on the character c.
+    constexpr bool viable(char c) const {
+        return nullable || chars.contains(c);
+    }
+};
+
+/// @brief Common base of every parser object built by the combinators below.
+/// @note Only used to restrict the operator overloads to parser operands.
+struct parser_base {};
+
+template<typename T>
+concept Parser = std::derived_from<std::remove_cvref_t<T>, parser_base>;
+
+/// @brief Runs a parser without throwing on failure.
+/// @tparam P The type of the parser.
+/// @tparam I The type of the input iterator.
+/// @param parser The parser to run.
+/// @param str_iter The input iterator to parse from.
+/// @param end The end of the input.
+/// @return The parse_result of the parser.
+/// @note Parsers built by this library and parsers that already return a
+///       parse_result are called directly. Any other callable is treated as a
+///       legacy throwing parser, and its std::runtime_error is turned into a
+///       parse_error (a fatal one for cut_error). Legacy parsers that take no end are called without it.
+///       Without exceptions (see SIMPARSE_EXCEPTIONS) legacy parsers cannot fail.
+template<typename P, CharIterator I, CharSentinel<I> S = null_sentinel>
+auto try_parse(const P& parser, I& str_iter, S end = {}) {
+    if constexpr (requires { parser.try_parse(str_iter, end); }) {
+        return parser.try_parse(str_iter, end);
+    } else {
+        auto call = [&]() -> decltype(auto) {
+            if constexpr (std::invocable<const P&, I&, S>) {
+                return parser(str_iter, end);
+            } else {
+                return parser(str_iter);
+            }
+        };
+        using T = decltype(call());
+        if constexpr (detail::is_parse_result<T>::value) {
+            return call();
+        } else {
+#if SIMPARSE_EXCEPTIONS
+            try {
+                return parse_result<T>(call());
+            } catch (const cut_error&) {
+                return parse_result<T>(parse_error{"Committed parser failed.", true});
+            } catch (const std::runtime_error&) {
+                return parse_result<T>(parse_error{"Parser failed."});
+            }
+#else
+            return parse_result<T>(call());
+#endif
+        }
+    }
+}
+
+/// @brief Runs a parser only to consume its input, discarding the value.
+/// @tparam P The type of the parser.
+/// @tparam I The type of the input iterator.
+/// @param parser The parser to run.
+/// @param str_iter The input iterator to parse from.
+/// @param end The end of the input.
+/// @return An empty parse_result on success, the parse_error otherwise.
+/// @note Parsers that can recognize their input without building a value
+///       (e.g. `many` or `string`) provide a `try_skip` which is used here.
+template<typename P, CharIterator I, CharSentinel<I> S = null_sentinel>
+auto try_skip(const P& parser, I& str_iter, S end = {}) -> parse_result<void> {
+    if constexpr (requires { parser.try_skip(str_iter, end); }) {
+        return parser.try_skip(str_iter, end);
+    } else {
+        auto result = try_parse(parser, str_iter, end);
+        if (!result) {
+            return result.error();
+        }
+        return {};
+    }
+}
+
+/// @brief The value type produced by the parser P on the iterator I and the sentinel S.
+template<typename P, typename I, typename S = null_sentinel>
+using parsed_t = typename decltype(
+    try_parse(std::declval<const std::remove_cvref_t<P>&>(), std::declval<I&>(), std::declval<S>())
+)::value_type;
+
+/// @brief Returns the first set of the parser, or first_set::unknown() if it cannot be analysed.
+/// @tparam P The type of the parser.
+/// @param parser The parser to analyse.
+template<typename P>
+constexpr first_set first_of(const P& parser) {
+    if constexpr (requires { { parser.first() } -> std::same_as<first_set>; }) {
+        return parser.first();
+    } else {
+        return first_set::unknown();
+    }
+}
+
+/// @brief Marks a basic_parser without a dedicated skip function.
+struct no_skip {};
+
+/// @brief Asks a parse function for the parsed value.
+struct parse_mode {
+    static constexpr bool skip = false;
+};
+
+/// @brief Asks a parse function to only consume its input.
+/// @note Combinators take the mode as an optional third argument, so one
+///       closure (and one copy of the operands) serves both `try_parse` and
+///       `try_skip`.
+struct skip_mode {
+    static constexpr bool skip = true;
+};
+
+namespace detail {
+
+/// @brief The result of a parse function run in mode M for the value type T.
+template<typename M, typename T>
+using mode_result_t = std::conditional_t<M::skip, parse_result<void>, parse_result<T>>;
+
+/// @brief Runs the parser with `try_skip` or `try_parse` according to the mode M.
+template<typename M, typename P, CharIterator I, CharSentinel<I> S>
+auto run_mode(const P& parser, I& str_iter, S end) {
+    if constexpr (M::skip) {
+        return try_skip(parser, str_iter, end);
+    } else {
+        return try_parse(parser, str_iter, end);
+    }
+}
+
+}
+
+/// @brief Wraps a non-throwing parse function into a parser object.
+/// @tparam F The type of the parse function, returning a parse_result.
+/// @tparam K The type of the optional skip function, returning a parse_result<void>.
+/// @note `try_parse` reports failure as a value. The call operator is the
+///       throwing interface kept for compatibility. Both take an optional end
+///       of the input; without it the input ends at the first '\0'.
+template<typename F, typename K = no_skip>
+struct basic_parser : parser_base {
+    F parse_fn;
+    [[no_unique_address]] K skip_fn;
+    first_set first_chars;
+
+    explicit basic_parser(F fn, K skip = {}, first_set first = first_set::unknown())
+        : parse_fn(std::move(fn)), skip_fn(std::move(skip)), first_chars(first) {}
+
+    first_set first() const {
+        return first_chars;
+    }
+
+    template<CharIterator I, CharSentinel<I> S = null_sentinel>
+    auto try_parse(I& str_iter, S end = {}) const {
+        return parse_fn(str_iter, end);
+    }
+
+    template<CharIterator I, CharSentinel<I> S = null_sentinel>
+    auto try_skip(I& str_iter, S end = {}) const -> parse_result<void> {
+        if constexpr (std::same_as<K, no_skip> && requires { parse_fn(str_iter, end, skip_mode{}); }) {
+            return parse_fn(str_iter, end, skip_mode{});
+        } else if constexpr (std::same_as<K, no_skip>) {
+            auto result = parse_fn(str_iter, end);
+            if (!result) {
+                return result.error();
+            }
+            return {};
+        } else {
+            return skip_fn(str_iter, end);
+        }
+    }
+
+    template<CharIterator I, CharSentinel<I> S = null_sentinel>
+    auto operator()(I& str_iter, S end = {}) const {
+        auto result = parse_fn(str_iter, end);
+        if (!result) {
+            detail::raise_parse_error(result.error());
+        }
+        return std::move(*result);
+    }
+};
+
+/// @brief Creates a parser object from a non-throwing parse function.
+/// @tparam F The type of the parse function.
+/// @param fn The parse function, taking an iterator and an end, and returning a parse_result.
+template<typename F>
+auto make_parser(F fn) {
+    return basic_parser<F>(std::move(fn));
+}
+
+/// @brief Creates a parser object from a parse function and a skip function.
+/// @tparam F The type of the parse function.
+/// @tparam K The type of the skip function.
+/// @param fn The parse function, taking an iterator and returning a parse_result.
+/// @param skip The skip function, consuming the same input without building a value.
+template<typename F, typename K>
+auto make_parser(F fn, K skip) {
+    return basic_parser<F, K>(std::move(fn), std::move(skip));
+}
+
+/// @brief Creates a parser object with a known first set.
+/// @tparam F The type of the parse function.
+/// @tparam K The type of the skip function, or no_skip.
+/// @param fn The parse function, taking an iterator and returning a parse_result.
+/// @param skip The skip function, consuming the same input without building a value.
+/// @param first The characters the parser can start with.
+template<typename F, typename K>
+auto make_parser(F fn, K skip, first_set first) {
+    return basic_parser<F, K>(std::move(fn), std::move(skip), first);
+}
+
+/// @brief Characters of the input buffer, the result of `view`.
+/// @note A `std::string_view` that is known to point into the input. A sequence
+///       merges the adjacent input views of its children into one view; any
+///       other `std::string_view` results are copied into a `std::string`.
+struct input_view : std::string_view {
+    constexpr input_view() noexcept = default;
+    constexpr input_view(const char* data, std::size_t size) noexcept : std::string_view(data, size) {}
+};
+
+namespace detail {
+
+/// @brief Returns the operand a combinator stores: a reference for a `rule`, a copy otherwise.
+/// @note Rules are not copyable; storing a reference is what lets a rule appear
+///       in its own definition.
+template<typename P>
+auto hold(P&& parser) {
+    if constexpr (requires { parser.ref(); }) {
+        return parser.ref();
+    } else {
+        return std::remove_cvref_t<P>(std::forward<P>(parser));
+    }
+}
+
+/// @brief The type a combinator stores for the operand P.
+template<typename P>
+using held_t = decltype(hold(std::declval<P>()));
+
+/// @brief The value type of concatenating the results L and R.
+/// @note Two input views are merged into one view, since consecutive parsers
+///       consume adjacent ranges of the input. Other views may point anywhere,
+///       so they are copied.
+template<typename L, typename R>
+struct concat {
+    using type = L;
+};
+
+template<typename R>
+struct concat<std::string_view, R> {
+    using type = std::string;
+};
+
+template<typename R>
+struct concat<input_view, R> {
+    using type = std::string;
+};
+
+template<>
+struct concat<input_view, input_view> {
+    using type = input_view;
+};
+
+template<typename L, typename R>
+using concat_t = typename concat<L, R>::type;
+
+/// @brief The first set of `a` followed by `b`.
+constexpr first_set first_of_sequence(const first_set& a, const first_set& b) {
+    if (!a.nullable) {
+        return a;
+    }
+    return {a.chars | b.chars, b.nullable};
+}
+
+/// @brief The first set of a choice between `a` and `b`.
+constexpr first_set first_of_choice(const first_set& a, const first_set& b) {
+    return {a.chars | b.chars, a.nullable || b.nullable};
+}
+
+}
+
 
 template<std::invocable<char> F>
 auto satisfy(F&& cond) {
-    return [=]<CharIterator I>(I& str_iter) -> char {
-        if (*str_iter == '\0') {
-            throw std::runtime_error("End of string reached.");
+    return make_parser([=]<CharIterator I, CharSentinel<I> S>(I& str_iter, S end) -> parse_result<char> {
+        if (str_iter == end) {
+            return parse_error{"End of string reached."};
         }
         auto s = *str_iter; 
         if (cond(s)) {
             ++str_iter;
             return s;
         } else {
-            throw std::runtime_error("Condition not satisfied.");
+            return parse_error{"Condition not satisfied."};
         }
-    };
+    }, no_skip{}, first_set{char_class::all(), false});
 }
 
+/// @brief An inclusive range of bytes.
+struct char_range {
+    unsigned char lo;
+    unsigned char hi;
+};
+
+/// @brief A character class described by a few inclusive byte ranges.
+/// @note Used to match classes made of few ranges (digits, letters, blanks)
+///       with plain SSE2 compares.
+struct char_ranges {
+    static constexpr std::size_t capacity = 4;
+
+    std::array<char_range, capacity> ranges{};
+    std::uint8_t count = 0;
+
+    constexpr char_ranges() = default;
+
+    constexpr char_ranges(std::initializer_list<char_range> list) {
+        for (auto r : list) {
+            ranges[count++] = r;
+        }
+    }
+
+    /// @brief Splits the class into ranges.
+    /// @return The ranges, or std::nullopt if the class needs more than `capacity` ranges.
+    static constexpr std::optional<char_ranges> from(const char_class& cls) {
+        char_ranges result;
+        unsigned u = 0;
+        while (u < 256) {
+            if (!cls.contains(static_cast<char>(u))) {
+                ++u;
+                continue;
+            }
+            auto lo = u;
+            while (u < 256 && cls.contains(static_cast<char>(u))) {
+                ++u;
+            }
+            if (result.count == capacity) {
+                return std::nullopt;
+            }
+            result.ranges[result.count++] = {static_cast<unsigned char>(lo), static_cast<unsigned char>(u - 1)};
+        }
+        return result;
+    }
+
+    constexpr bool contains(char c) const {
+        auto u = static_cast<unsigned char>(c);
+        for (std::size_t i = 0; i < count; ++i) {
+            if (static_cast<unsigned char>(u - ranges[i].lo) <= ranges[i].hi - ranges[i].lo) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+#if defined(__SSE2__)
+    /// @brief Returns one bit per byte of `v` that belongs to the class.
+    std::uint32_t members(__m128i v) const {
+        auto hit = _mm_setzero_si128();
+        for (std::size_t i = 0; i < count; ++i) {
+            auto d = _mm_sub_epi8(v, _mm_set1_epi8(static_cast<char>(ranges[i].lo)));
+            auto w = _mm_set1_epi8(static_cast<char>(ranges[i].hi - ranges[i].lo));
+            hit = _mm_or_si128(hit, _mm_cmpeq_epi8(_mm_min_epu8(d, w), d));
+        }
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(hit));
+    }
+#endif
+
+#if defined(__AVX2__)
+    std::uint32_t members(__m256i v) const {
+        auto hit = _mm256_setzero_si256();
+        for (std::size_t i = 0; i < count; ++i) {
+            auto d = _mm256_sub_epi8(v, _mm256_set1_epi8(static_cast<char>(ranges[i].lo)));
+            auto w = _mm256_set1_epi8(static_cast<char>(ranges[i].hi - ranges[i].lo));
+            hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(_mm256_min_epu8(d, w), d));
+        }
+        return static_cast<std::uint32_t>(_mm256_movemask_epi8(hit));
+    }
+#endif
+};
+
+/// @brief Matches an arbitrary class with two nibble shuffles.
+/// @note The bitmap is split into one 16-bit row per high nibble. `rows_lo`
+///       and `rows_hi` hold the low and high byte of every row; the low nibble
+///       then selects the byte and the bit within it. The tables are cheap to
+///       build from the bitmap, so they are made when a scan starts.
+struct char_nibbles {
+    std::array<std::uint8_t, 16> rows_lo{};
+    std::array<std::uint8_t, 16> rows_hi{};
+    char_class cls;
+
+    constexpr char_nibbles() = default;
+
+    constexpr explicit char_nibbles(const char_class& c) : cls(c) {
+        for (std::size_t h = 0; h < 16; ++h) {
+            rows_lo[h] = static_cast<std::uint8_t>(c.row(h));
+            rows_hi[h] = static_cast<std::uint8_t>(c.row(h) >> 8);
+        }
+    }
+
+    constexpr bool contains(char c) const {
+        return cls.contains(c);
+    }
+
+#if defined(__SSSE3__)
+    std::uint32_t members(__m128i v) const {
+        const auto nibble = _mm_set1_epi8(0x0f);
+        const auto bits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+        auto hi = _mm_and_si128(_mm_srli_epi16(v, 4), nibble);
+        auto lo = _mm_and_si128(v, nibble);
+        auto row_lo = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rows_lo.data())), hi);
+        auto row_hi = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rows_hi.data())), hi);
+        auto upper = _mm_cmpgt_epi8(lo, _mm_set1_epi8(7));
+        auto row = _mm_or_si128(_mm_andnot_si128(upper, row_lo), _mm_and_si128(upper, row_hi));
+        auto bit = _mm_shuffle_epi8(bits, lo);
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(row, bit), bit)));
+    }
+#endif
+
+#if defined(__AVX2__)
+    std::uint32_t members(__m256i v) const {
+        const auto nibble = _mm256_set1_epi8(0x0f);
+        const auto bits = _mm256_setr_epi8(
+            1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+            1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+        auto table_lo = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rows_lo.data())));
+        auto table_hi = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rows_hi.data())));
+        auto hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble);
+        auto lo = _mm256_and_si256(v, nibble);
+        auto upper = _mm256_cmpgt_epi8(lo, _mm256_set1_epi8(7));
+        auto row = _mm256_blendv_epi8(_mm256_shuffle_epi8(table_lo, hi), _mm256_shuffle_epi8(table_hi, hi), upper);
+        auto bit = _mm256_shuffle_epi8(bits, lo);
+        return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(row, bit), bit)));
+    }
+#endif
+};
+
+namespace detail {
+
+#if defined(__SSE2__)
+/// @brief 16-byte loads: one bit per byte that belongs to the class.
+struct simd16 {
+    using vector = __m128i;
+    static constexpr std::size_t width = 16;
+
+    template<typename K>
+    static std::uint32_t load(const K& kernel, const char* p) {
+        return kernel.members(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+    }
+
+    template<typename K>
+    SIMPARSE_NO_SANITIZE_ADDRESS
+    static std::uint32_t load_aligned(const K& kernel, const char* p) {
+        return kernel.members(_mm_load_si128(reinterpret_cast<const __m128i*>(p)));
+    }
+};
+#endif
+
+#if defined(__AVX2__)
+/// @brief 32-byte loads: one bit per byte that belongs to the class.
+struct simd32 {
+    using vector = __m256i;
+    static constexpr std::size_t width = 32;
+
+    template<typename K>
+    static std::uint32_t load(const K& kernel, const char* p) {
+        return kernel.members(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+    }
+
+    template<typename K>
+    SIMPARSE_NO_SANITIZE_ADDRESS
+    static std::uint32_t load_aligned(const K& kernel, const char* p) {
+        return kernel.members(_mm256_load_si256(reinterpret_cast<const __m256i*>(p)));
+    }
+};
+
+using simd = simd32;
+#elif defined(__SSE2__)
+using simd = simd16;
+#endif
+
+/// @brief Whether the kernel K can test a whole SIMD block at once.
+template<typename K>
+concept SimdKernel =
+#if defined(__SSE2__)
+    requires(const K& kernel, simd::vector v) { kernel.members(v); };
+#else
+    false;
+#endif
+
+/// @brief Returns the end of the run of class members starting at `first`.
+/// @param padding The number of readable bytes past `last`. With enough
+///        padding the last block is loaded whole and no scalar tail runs.
+template<typename K>
+const char* scan_class(const K& kernel, const char* first, const char* last, std::size_t padding) {
+    auto p = first;
+    if constexpr (SimdKernel<K>) {
+        constexpr auto full = (std::uint64_t{1} << simd::width) - 1;
+        while (last - p >= static_cast<std::ptrdiff_t>(simd::width)
+               || (padding >= simd::width && p < last)) {
+            auto stop = ~std::uint64_t{simd::load(kernel, p)} & full;
+            if (stop != 0) {
+                return std::min(p + std::countr_zero(stop), last);
+            }
+            p += simd::width;
+        }
+        if (p >= last) {
+            return last;
+        }
+    }
+    while (p < last && kernel.contains(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+/// @brief Returns the end of the run of class members in a null-terminated buffer.
+/// @note The class must not contain '\0'. Loads are aligned, so the block that
+///       holds the terminator never crosses into an unmapped page.
+template<typename K>
+SIMPARSE_NO_SANITIZE_ADDRESS
+const char* scan_class_terminated(const K& kernel, const char* first) {
+    if constexpr (SimdKernel<K>) {
+        constexpr auto full = (std::uint64_t{1} << simd::width) - 1;
+        auto offset = reinterpret_cast<std::uintptr_t>(first) % simd::width;
+        auto p = first - offset;
+        auto stop = ~std::uint64_t{simd::load_aligned(kernel, p)} & full & (full << offset);
+        while (stop == 0) {
+            p += simd::width;
+            stop = ~std::uint64_t{simd::load_aligned(kernel, p)} & full;
+        }
+        return p + std::countr_zero(stop);
+    } else {
+        auto p = first;
+        while (kernel.contains(*p)) {
+            ++p;
+        }
+        return p;
+    }
+}
+
+}
+
+/// @brief A parser for a single character of a char_class.
+/// @note Behaves like `satisfy` with the class as condition, with a single
+///       bitmap lookup per character. In addition, `many` recognizes it and
+///       scans the whole run at once on contiguous input: classes made of few
+///       ranges use SSE2 range compares, others a nibble shuffle (SSSE3).
+struct class_parser : parser_base {
+    char_class cls;
+    std::optional<char_ranges> ranges;
+
+    constexpr class_parser(const char_class& c)
+        : cls(c), ranges(char_ranges::from(c)) {}
+
+    template<CharIterator I, CharSentinel<I> S = null_sentinel>
+    auto try_parse(I& str_iter, S end = {}) const -> parse_result<char> {
+        if (str_iter == end) {
+            return parse_error{"End of string reached."};
+        }
+        auto s = *str_iter;
+        if (!cls.contains(s)) {
+            return parse_error{"Condition not satisfied."};
+        }
+        ++str_iter;
+        return s;
+    }
+
+    template<CharIterator I, CharSentinel<I> S = null_sentinel>
+    auto operator()(I& str_iter, S end = {}) const {
+        auto result = try_parse(str_iter, end);
+        if (!result) {
+            detail::raise_parse_error(result.error());
+        }
+        return *result;
+    }
+
+    constexpr first_set first() const {
+        return {cls, false};
+    }
+
+    /// @brief Whether `scan` supports the iterator I with the sentinel S.
+    template<typename I, typename S>
+    static constexpr bool can_scan = std::contiguous_iterator<I>
+        && (std::same_as<S, I> || std::same_as<S, null_sentinel> || detail::padding_v<S> > 0);
+
+    /// @brief Advances `str_iter` past the run of class members.
+    template<CharIterator I, CharSentinel<I> S>
+        requires can_scan<I, S>
+    void scan(I& str_iter, S end) const {
+        auto first = std::to_address(str_iter);
+        const char* stop;
+        if (ranges) {
+            stop = scan_with<I>(*ranges, first, end);
+        } else {
+            stop = scan_with<I>(char_nibbles(cls), first, end);
+        }
+        str_iter += stop - first;
+    }
+
+    /// @brief The union of two classes, matched with one lookup.
+    friend constexpr class_parser operator|(class_parser a, class_parser b) {
+        return class_parser(a.cls | b.cls);
+    }
+
+    /// @brief The intersection of two classes.
+    friend constexpr class_parser operator&(class_parser a, class_parser b) {
+        return class_parser(a.cls & b.cls);
+    }
+
+    /// @brief Every character not in the class.
+    friend constexpr class_parser operator~(class_parser a) {
+        return class_parser(~a.cls);
+    }
+
+private:
+    template<CharIterator I, typename K, CharSentinel<I> S>
+    const char* scan_with(const K& kernel, const char* first, S end) const {
+        if constexpr (std::same_as<S, null_sentinel>) {
+            if (cls.contains('\0')) {
+                auto stop = first;
+                while (*stop != '\0' && cls.contains(*stop)) {
+                    ++stop;
+                }
+                return stop;
+            }
+            return detail::scan_class_terminated(kernel, first);
+        } else if constexpr (std::same_as<S, I>) {
+            return detail::scan_class(kernel, first, std::to_address(end), 0);
+        } else {
+            return detail::scan_class(kernel, first, std::to_address(end.end), detail::padding_v<S>);
+        }
+    }
+};
+
 /// @brief Parses a specified number of characters from the input iterator.
 /// @tparam F The type of the parser function.
 /// @param n The number of characters to parse.
 template<typename F>
 auto rep(size_t n, F&& parser) {
-    return [=]<CharIterator I>(I& str_iter) {
-        std::string result;
+    return make_parser([=, parser = detail::hold(parser)]<CharIterator I, CharSentinel<I> S, typename M = parse_mode>(I& str_iter, S end, M = {})
+        -> detail::mode_result_t<M, std::string> {
+        [[maybe_unused]] std::string result;
+        detail::cut_mark cut;
         for (size_t i = 0; i < n; ++i) {
-            result += parser(str_iter);
+            auto r = detail::run_mode<M>(parser, str_iter, end);
+            cut.seal(r);
+            if (!r) {
+                return r.error();
+            }
+            if constexpr (!M::skip) {
+                result += *r;
+            }
         }
-        return result;
-    };
+        if constexpr (M::skip) {
+            return {};
+        } else {
+            return result;
+        }
+    }, no_skip{}, n == 0 ? first_set{char_class{}, true} : first_of(parser));
 }
 
 /// @brief Ignores the underlying parser and returns an empty string.
@@ -46,10 +1023,130 @@ auto rep(size_t n, F&& parser) {
 /// @return A parser function that ignores the underlying parser.
 template<typename F>
 auto ignore(F&& parser) {
-    return [=]<CharIterator I>(I& str_iter) {
-        parser(str_iter);
-        return std::string{};
-    };
+    return make_parser([=, parser = detail::hold(parser)]<CharIterator I, CharSentinel<I> S, typename M = parse_mode>(I& str_iter, S end, M = {})
+        -> detail::mode_result_t<M, std::string> {
+        auto r = try_skip(parser, str_iter, end);
+        if (!r) {
+            return r.error();
+        }
+        if constexpr (M::skip) {
+            return {};
+        } else {
+            return std::string{};
+        }
+    }, no_skip{}, first_of(parser));
+}
+
+namespace detail {
+
+/// @brief Calls the semantic action with the moved result, or with the moved
+///        elements of a tuple result (e.g. from `seq_tuple`).
+template<typename Fn, typename V>
+decltype(auto) apply_action(const Fn& fn, V&& value) {
+    if constexpr (std::invocable<const Fn&, V&&>) {
+        return std::invoke(fn, std::forward<V>(value));
+    } else {
+        return std::apply(fn, std::forward<V>(value));
+    }
+}
+
+/// @brief Adds the moved result to the accumulator: in place if the operation
+///        returns void, otherwise by assigning the returned accumulator.
+template<typename Op, typename T, typename V>
+void fold_step(const Op& op, T& acc, V&& value) {
+    if constexpr (std::is_void_v<std::invoke_result_t<const Op&, T&, V&&>>) {
+        std::invoke(op, acc, std::forward<V>(value));
+    } else {
+        acc = std::invoke(op, std::move(acc), std::forward<V>(value));
+    }
+}
+
+/// @brief The fold operation of `many`: appends each result to a string.
+struct append_result {
+    template<typename V>
+    void operator()(std::string& acc, const V& value) const {
+        acc += value;
+    }
+};
+
+}
+
+/// @brief Transforms the result of the parser with a semantic action.
+/// @tparam F The type of the parser function.
+/// @tparam Fn The type of the action.
+/// @param parser The parser function to use.
+/// @param fn The action, called with the moved result. A tuple result (e.g. from
+///           `seq_tuple`) is unpacked into the arguments if `fn` does not take
+///           the tuple itself.
+/// @return A parser function that returns the value returned by the action.
+/// @note The action is not called when the parser is only skipped.
+template<typename F, typename Fn>
+auto map(F&& parser, Fn fn) {
+    return make_parser([=, parser = detail::hold(parser)]<CharIterator I, CharSentinel<I> S, typename M = parse_mode>(I& str_iter, S end, M = {})
+        -> detail::mode_result_t<M, std::decay_t<decltype(detail::apply_action(fn, std::declval<parsed_t<F, I, S>>()))>> {
+        auto r = detail::run_mode<M>(parser, str_iter, end);
+        if (!r) {
+            return r.error();
+        }
+        if constexpr (M::skip) {
+            return {};
+        } else {
+            return detail::apply_action(fn, std::move(*r));
+        }
+    }, no_skip{}, first_of(parser));
+}
+
+/// @brief Folds zero or more results of the parser into an accumulator.
+/// @tparam F The type of the parser function.
+/// @tparam T The type of the accumulator.
+/// @tparam Op The type of the fold operation.
+/// @param parser The parser function to repeat.
+/// @param init The initial accumulator, copied for each parse.
+/// @param op Either `void(T&, V&&)`, which updates the accumulator in place, or
+///           `T(T&&, V&&)`, which returns the next one. Results are passed by move.
+/// @return A parser function that returns the accumulator.
+/// @note Repeats like `many`: stops at the first failure, unless it is fatal
+///       (see `commit`). The operation is not called when the parser is only skipped.
+template<typename F, typename T, typename Op>
+auto fold(F&& parser, T init, Op op) {
+    using P = std::remove_cvref_t<F>;
+    return make_parser([=, parser = detail::hold(parser)]<CharIterator I, CharSentinel<I> S, typename M = parse_mode>(I& str_iter, S end, M = {})
+        -> detail::mode_result_t<M, T> {
+        if constexpr (std::same_as<Op, detail::append_result> && std::same_as<P, class_parser> && class_parser::can_scan<I, S>) {
+            [[maybe_unused]] auto first = str_iter;
+            parser.scan(str_iter, end);
+            if constexpr (M::skip) {
+                return {};
+            } else {
+                T acc = init;
+                acc.append(std::to_address(first), static_cast<std::size_t>(str_iter - first));
+                return acc;
+            }
+        }
+        [[maybe_unused]] std::conditional_t<M::skip, std::monostate, T> acc{};
+        if constexpr (!M::skip) {
+            acc = init;
+        }
+        while (true) {
+            detail::cut_mark cut;
+            auto r = detail::run_mode<M>(parser, str_iter, end);
+            if (!r) {
+                if (r.error().fatal) {
+                    return r.error();
+                }
+                break;
+            }
+            cut.close();
+            if constexpr (!M::skip) {
+                detail::fold_step(op, acc, std::move(*r));
+            }
+        }
+        if constexpr (M::skip) {
+            return {};
+        } else {
+            return acc;
+        }
+    }, no_skip{}, first_set{first_of(parser).chars, true});
 }
 
 /// @brief Parses zero or more characters from the input iterator.
@@ -60,20 +1157,49 @@ auto ignore(F&& parser) {
 ///       It will return the concatenated result of all successful parses.
 ///       If the parser fails immediately, it will return an empty string.
 ///       If the parser fails after some successful parses, it will return
-///       the concatenated result of those successful parses.
+///       the concatenated result of those successful parses, unless the
+///       failure is fatal (see `commit`).
+///       A character class parser (e.g. `whitespace`) on contiguous input is
+///       scanned with SIMD compares and copied once.
+///       This is `fold(parser, std::string{}, append)`.
 template<typename F>
 auto many(F&& parser) {
-    return [=]<CharIterator I>(I& str_iter) {
-        std::string result;
+    return fold(std::forward<F>(parser), std::string{}, detail::append_result{});
+}
+
+/// @brief Appends zero or more results of the parser to a container.
+/// @tparam F The type of the parser function.
+/// @tparam C The type of the container, e.g. `std::vector<T>`.
+/// @param parser The parser function to repeat.
+/// @param out The container, which must outlive the parser. Results are moved
+///            in with `push_back`, or `insert` at the end.
+/// @return A parser function that returns the number of results appended.
+/// @note Repeats like `many`. The results are appended even when the parser is
+///       only skipped.
+template<typename F, typename C>
+auto many_into(F&& parser, C& out) {
+    return make_parser([=, parser = detail::hold(parser), out = &out]<CharIterator I, CharSentinel<I> S>(I& str_iter, S end)
+        -> parse_result<std::size_t> {
+        std::size_t count = 0;
         while (true) {
-            try {
-                result += parser(str_iter);
-            } catch (std::runtime_error&) {
+            detail::cut_mark cut;
+            auto r = try_parse(parser, str_iter, end);
+            if (!r) {
+                if (r.error().fatal) {
+                    return r.error();
+                }
                 break;
             }
+            cut.close();
+            if constexpr (requires { out->push_back(std::move(*r)); }) {
+                out->push_back(std::move(*r));
+            } else {
+                out->insert(out->end(), std::move(*r));
+            }
+            ++count;
         }
-        return result;
-    };
+        return count;
+    }, no_skip{}, first_set{first_of(parser).chars, true});
 }
 
 /// @brief Creates a parser that matches any characters except for the given character.
@@ -81,9 +1207,8 @@ auto many(F&& parser) {
 /// @param c The character to exclude.
 /// @return A parser function that matches any character except for the given character.
 /// @note This parser will consume characters until it encounters the excluded character.
-template<typename F>
-auto exclude(char c) {
-    return satisfy([=](char s) { return c != s; });
+inline auto exclude(char c) {
+    return class_parser(~char_class::of(c));
 }
 
 /// @brief Creates a parser that matches a specific character.
@@ -93,7 +1218,34 @@ auto exclude(char c) {
 /// @note This parser will consume characters until the specified character is matched.
 ///       If the character is not matched, it will throw an exception.
 inline auto character(char c) {
-    return satisfy([=](char s) { return c == s; });
+    return class_parser(char_class::of(c));
+}
+
+namespace detail {
+
+/// @brief Matches the literal `str` at `str_iter`, advancing up to the first mismatch.
+/// @note With a padded sentinel the whole literal is compared at once and the
+///       bound is checked afterwards; the per-character loop only runs to
+///       locate a mismatch.
+template<CharIterator I, CharSentinel<I> S>
+bool match_string(const std::string& str, I& str_iter, S end) {
+    if constexpr (padding_v<S> > 0 && std::contiguous_iterator<I>) {
+        if (str.size() <= padding_v<S>
+            && std::memcmp(std::to_address(str_iter), str.data(), str.size()) == 0
+            && static_cast<std::size_t>(end.end - str_iter) >= str.size()) {
+            str_iter += static_cast<std::iter_difference_t<I>>(str.size());
+            return true;
+        }
+    }
+    for (char c : str) {
+        if (str_iter == end || *str_iter != c) {
+            return false;
+        }
+        ++str_iter;
+    }
+    return true;
+}
+
 }
 
 /// @brief Creates a parser that matches a specific string.
@@ -103,32 +1255,164 @@ inline auto character(char c) {
 /// @note This parser will consume characters until the entire string is matched.
 ///       If the string is not matched, it will throw an exception.
 inline auto string(std::string str) {
-    return [=]<CharIterator I>(I& str_iter) {
-        for (char c : str) {
-            if (*str_iter != c) {
-                throw std::runtime_error("String not matched: \"" + str + "\"");
+    return make_parser([=]<CharIterator I, CharSentinel<I> S, typename M = parse_mode>(I& str_iter, S end, M = {})
+        -> detail::mode_result_t<M, std::string> {
+        if (!detail::match_string(str, str_iter, end)) {
+            return parse_error{"String not matched."};
+        }
+        if constexpr (M::skip) {
+            return {};
+        } else {
+            return str;
+        }
+    }, no_skip{}, str.empty() ? first_set{char_class{}, true} : first_set{char_class::of(str[0]), false});
+}
+
+namespace detail {
+
+/// @brief A trie over a set of keywords, laid out for O(length) matching.
+/// @note The children of a node are stored contiguously in character order,
+///       so the child for c is found with the rank of c in the node's
+///       char_class instead of a search.
+class keyword_trie {
+public:
+    keyword_trie(const std::vector<std::string>& keywords, bool case_insensitive)
+        : case_insensitive_(case_insensitive) {
+        struct draft {
+            std::map<unsigned char, std::size_t> children;
+            std::ptrdiff_t keyword = -1;
+        };
+        std::vector<draft> drafts(1);
+        for (std::size_t k = 0; k < keywords.size(); ++k) {
+            std::size_t node = 0;
+            for (char c : keywords[k]) {
+                auto key = static_cast<unsigned char>(fold(c));
+                auto found = drafts[node].children.find(key);
+                if (found == drafts[node].children.end()) {
+                    drafts.emplace_back();
+                    found = drafts[node].children.emplace(key, drafts.size() - 1).first;
+                }
+                node = found->second;
+            }
+            if (drafts[node].keyword < 0) {
+                drafts[node].keyword = static_cast<std::ptrdiff_t>(k);
             }
-            ++str_iter;
         }
-        return str;
+
+        // Breadth-first layout: the children of every node become adjacent.
+        std::vector<std::size_t> order{0};
+        nodes_.resize(drafts.size());
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            auto& d = drafts[order[i]];
+            auto& n = nodes_[i];
+            n.keyword = d.keyword;
+            n.first_child = order.size();
+            for (auto [c, child] : d.children) {
+                n.children = n.children | char_class::of(static_cast<char>(c));
+                order.push_back(child);
+            }
+        }
+
+        for (const auto& keyword : keywords) {
+            if (keyword.empty()) {
+                first_.nullable = true;
+                continue;
+            }
+            first_.chars = first_.chars | char_class::of(keyword[0]);
+            if (case_insensitive_) {
+                first_.chars = first_.chars | char_class::of(fold(keyword[0])) | char_class::of(upper(keyword[0]));
+            }
+        }
+    }
+
+    /// @brief Matches the longest keyword at `str_iter`.
+    /// @return The index of the keyword, or -1 if none matches. On success the
+    ///         iterator is moved past the keyword; otherwise it is unchanged.
+    template<CharIterator I, CharSentinel<I> S>
+    std::ptrdiff_t match(I& str_iter, S end) const {
+        const node* n = &nodes_[0];
+        auto best = n->keyword;
+        auto best_pos = str_iter;
+        auto it = str_iter;
+        while (it != end) {
+            auto c = fold(*it);
+            if (!n->children.contains(c)) {
+                break;
+            }
+            n = &nodes_[n->first_child + n->children.rank(c)];
+            ++it;
+            if (n->keyword >= 0) {
+                best = n->keyword;
+                best_pos = it;
+            }
+        }
+        if (best >= 0) {
+            str_iter = best_pos;
+        }
+        return best;
+    }
+
+    const first_set& first() const {
+        return first_;
+    }
+
+private:
+    struct node {
+        char_class children;
+        std::size_t first_child = 0;
+        std::ptrdiff_t keyword = -1;
     };
+
+    char fold(char c) const {
+        return case_insensitive_ && c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    static char upper(char c) {
+        return c >= 'a' && c <= 'z' ? static_cast<char>(c - 'a' + 'A') : c;
+    }
+
+    std::vector<node> nodes_;
+    first_set first_{char_class{}, false};
+    bool case_insensitive_;
+};
+
+}
+
+/// @brief Creates a parser that matches one of the given keywords.
+/// @param keywords The keywords to match.
+/// @param case_insensitive Whether ASCII letters match regardless of case.
+/// @return A parser function that returns the index of the matched keyword.
+/// @note The keywords are compiled into a trie, so matching costs O(length)
+///       whatever the number of keywords. The longest matching keyword wins;
+///       for duplicates the first index is returned. If no keyword matches,
+///       the iterator is not modified.
+inline auto one_of_strings(std::vector<std::string> keywords, bool case_insensitive = false) {
+    auto trie = std::make_shared<const detail::keyword_trie>(keywords, case_insensitive);
+    return make_parser([=]<CharIterator I, CharSentinel<I> S>(I& str_iter, S end) -> parse_result<std::size_t> {
+        auto index = trie->match(str_iter, end);
+        if (index < 0) {
+            return parse_error{"No keyword matched."};
+        }
+        return static_cast<std::size_t>(index);
+    }, no_skip{}, trie->first());
 }
 
 /// @brief Backtraces the parser to the last successful position.
 /// @tparam F The type of the parser function.
 /// @param parser The parser function to use.
 /// @return A parser function that parses with the given parser object.
+/// @note A fatal failure leaves the iterator where it happened, so the error
+///       can be located.
 template<typename F>
 auto back(F&& parser) {
-    return [=]<CharIterator I>(I& str_iter) {
+    return make_parser([=, parser = detail::hold(parser)]<CharIterator I, CharSentinel<I> S, typename M = parse_mode>(I& str_iter, S end, M = {}) {
         auto pos = str_iter;
-        try {
-            return parser(str_iter);
-        } catch (const std::runtime_error&) {
+        auto result = detail::run_mode<M>(parser, str_iter, end);
+        if (!result && !result.error().fatal) {
             str_iter = pos;
-            throw;
         }
-    };
+        return result;
+    }, no_skip{}, first_of(parser));
 }
 
 /// @brief Peeks at the parser without consuming characters.
@@ -138,19 +1422,372 @@ auto back(F&& parser) {
 /// @note This parser will not consume any characters from the input iterator.
 ///       It will return the result of the parser without modifying the iterator.
 ///       If the parser fails, it will throw an exception and the iterator will not be modified.
+///       An `input_view` result is returned as a `std::string_view`, since the
+///       next parser starts at the same position rather than after it.
 template<typename F>
 auto peek(F&& parser) {
-    return [=]<CharIterator I>(I& str_iter) {
+    return make_parser([=, parser = detail::hold(parser)]<CharIterator I, CharSentinel<I> S, typename M = parse_mode>(I& str_iter, S end, M = {}) {
         auto pos = str_iter;
-        try {
-            auto str = parser(str_iter);
-            str_iter = pos;
-            return str;
-        } catch (const std::runtime_error&) {
-            str_iter = pos;
-            throw;
+        auto result = detail::run_mode<M>(parser, str_iter, end);
+        str_iter = pos;
+        if constexpr (std::same_as<decltype(result), parse_result<input_view>>) {
+            if (!result) {
+                return parse_result<std::string_view>(result.error());
+            }
+            return parse_result<std::string_view>(*result);
+        } else {
+            return result;
+        }
+    }, no_skip{}, first_of(parser));
+}
+
+namespace detail {
+
+/// @brief Tells an input source that no parser will rewind before `str_iter`.
+/// @note Iterators without a `commit` member (e.g. pointers) need no notice.
+template<CharIterator I>
+void commit_input(const I& str_iter) {
+    if constexpr (requires { str_iter.commit(); }) {
+        str_iter.commit();
+    }
+}
+
+}
+
+/// @brief Commits to the parser: once reached, the enclosing alternatives are not retried.
+/// @tparam F The type of the parser function.
+/// @param parser The parser function to commit to.
+/// @return A parser function that returns the result of the given parser.
+/// @note This is the PEG cut, e.g. `string("ZONE") + commit(zone_body) + string(";")`.
+///       Once it is reached, a failure of the parser or of anything after it in the
+///       enclosing sequences is fatal, until the enclosing alternative (of `operator|`,
+///       `alt`, or an iteration of `many`) ends. Fatal failures are propagated instead
+///       of backtracking, `back` does not rewind them, and the throwing interface
+///       raises a `cut_error`. Streaming sources are told that input before this
+///       point can be released, so do not wrap a commit inside `peek`.
+template<typename F>
+auto commit(F&& parser) {
+    return make_parser([=, parser = detail::hold(parser)]<CharIterator I, CharSentinel<I> S, typename M = parse_mode>(I& str_iter, S end, M = {}) {
+        detail::commit_input(str_iter);
+        ++detail::cut_count();
+        auto result = detail::run_mode<M>(parser, str_iter, end);
+        if (!result) {
+            return decltype(result)(parse_error{result.error().message, true});
         }
+        return result;
+    }, no_skip{}, first_of(parser));
+}
+
+/// @brief The results of memoized parsers, keyed by (rule id, position, end).
+class memo_table {
+public:
+    /// @brief Returns the cached entry of `rule` at `pos` for input ending at `end`, or nullptr.
+    std::any* find(std::size_t rule, std::uint64_t pos, std::uint64_t end) {
+        auto it = entries_.find(key{rule, pos, end});
+        return it == entries_.end() ? nullptr : &it->second;
+    }
+
+    void insert(std::size_t rule, std::uint64_t pos, std::uint64_t end, std::any entry) {
+        entries_.insert_or_assign(key{rule, pos, end}, std::move(entry));
+    }
+
+    std::size_t size() const noexcept { return entries_.size(); }
+    void clear() { entries_.clear(); }
+
+private:
+    struct key {
+        std::size_t rule;
+        std::uint64_t pos;
+        std::uint64_t end;
+        bool operator==(const key&) const = default;
     };
+
+    struct key_hash {
+        std::size_t operator()(const key& k) const noexcept {
+            return std::hash<std::uint64_t>{}((k.pos * 0x9E3779B97F4A7C15ull ^ k.end) * 0x9E3779B97F4A7C15ull ^ k.rule);
+        }
+    };
+
+    std::unordered_map<key, std::any, key_hash> entries_;
+};
+
+namespace detail {
+
+/// @brief The memo table of the current thread, installed by memo_scope.
+inline memo_table*& current_memo() {
+    thread_local memo_table* table = nullptr;
+    return table;
+}
+
+/// @brief Whether positions of the iterator I can key a memo table.
+template<typename I>
+concept MemoKey = std::contiguous_iterator<I>
+    || requires(const I& it) { { it.position() } -> std::convertible_to<std::uint64_t>; };
+
+template<MemoKey I>
+std::uint64_t memo_position(const I& str_iter) {
+    if constexpr (std::contiguous_iterator<I>) {
+        return reinterpret_cast<std::uintptr_t>(std::to_address(str_iter));
+    } else {
+        return str_iter.position();
+    }
+}
+
+/// @brief The position of the end of the input, for sentinels that carry one.
+/// @note Other sentinels (e.g. `null_sentinel`) are stateless, so the input
+///       itself decides where it ends.
+template<MemoKey I, typename S>
+std::uint64_t memo_end(const I& str_iter, const S& end) {
+    if constexpr (std::sized_sentinel_for<S, I>) {
+        return memo_position(str_iter) + static_cast<std::uint64_t>(end - str_iter);
+    } else if constexpr (requires { { end.end } -> std::convertible_to<I>; }) {
+        return memo_end(str_iter, I(end.end));
+    } else {
+        return ~std::uint64_t{0};
+    }
+}
+
+inline std::size_t next_memo_id() {
+    static std::atomic<std::size_t> id{0};
+    return id++;
+}
+
+}
+
+/// @brief Installs a memo table for the parses run on this thread while it is alive.
+/// @note Scopes nest; the previous table is restored on destruction. Use one
+///       scope per parse, since entries are keyed by input position.
+class memo_scope {
+public:
+    memo_scope() : previous_(std::exchange(detail::current_memo(), &table_)) {}
+    ~memo_scope() { detail::current_memo() = previous_; }
+
+    memo_scope(const memo_scope&) = delete;
+    memo_scope& operator=(const memo_scope&) = delete;
+
+    memo_table& table() noexcept { return table_; }
+
+private:
+    memo_table table_;
+    memo_table* previous_;
+};
+
+/// @brief Caches the outcome of the parser at each position (packrat parsing).
+/// @tparam F The type of the parser function.
+/// @param parser The parser function to memoize.
+/// @return A parser function that returns the result of the given parser.
+/// @note Within a memo_scope, the result and end position of the parser are
+///       recorded per position and end of input, along with whether it reached
+///       a `commit`, so retrying it at the same position through `back` and `|`
+///       costs one lookup. Copies of the returned parser share their cache entries;
+///       an entry recorded with another iterator type is treated as a miss. Without
+///       a scope, or on iterators that are neither contiguous nor expose `position()`,
+///       the parser runs uncached.
+template<typename F>
+auto memo(F&& parser) {
+    auto id = detail::next_memo_id();
+    return make_parser([=, parser = detail::hold(parser)]<CharIterator I, CharSentinel<I> S>(I& str_iter, S end) {
+        using R = decltype(try_parse(parser, str_iter, end));
+        if constexpr (detail::MemoKey<I>) {
+            if (auto* table = detail::current_memo()) {
+                auto pos = detail::memo_position(str_iter);
+                auto last = detail::memo_end(str_iter, end);
+                if (auto* entry = table->find(id, pos, last)) {
+                    if (auto* cached = std::any_cast<std::tuple<I, R, bool>>(entry)) {
+                        str_iter = std::get<0>(*cached);
+                        if (std::get<2>(*cached)) {
+                            ++detail::cut_count();
+                        }
+                        return std::get<1>(*cached);
+                    }
+                }
+                detail::cut_mark cut;
+                auto result = try_parse(parser, str_iter, end);
+                table->insert(id, pos, last, std::tuple<I, R, bool>(str_iter, result, cut.reached()));
+                return result;
+            }
+        }
+        return try_parse(parser, str_iter, end);
+    }, no_skip{}, first_of(parser));
+}
+
+namespace detail {
+
+/// @brief The value type of concatenating the results Ts from left to right.
+template<typename T, typename... Ts>
+struct concat_fold {
+    using type = T;
+};
+
+template<typename A, typename B, typename... Ts>
+struct concat_fold<A, B, Ts...> : concat_fold<concat_t<A, B>, Ts...> {};
+
+template<typename... Ts>
+using concat_fold_t = typename concat_fold<Ts...>::type;
+
+/// @brief The number of characters a value adds to a concatenated string.
+template<typename V>
+std::size_t value_size(const V& value) {
+    if constexpr (requires { value.size(); }) {
+        return value.size();
+    } else {
+        return 1;
+    }
+}
+
+template<typename V>
+void append_value(std::string& out, const V& value) {
+    if constexpr (std::convertible_to<const V&, std::string_view>) {
+        out.append(std::string_view(value));
+    } else {
+        out += value;
+    }
+}
+
+template<typename T, typename V, typename... Vs>
+T concat_values(V&& first, Vs&&... rest) {
+    T result(std::forward<V>(first));
+    ((result += rest), ...);
+    return result;
+}
+
+}
+
+/// @brief Runs parsers one after another in a single frame.
+/// @tparam Tuple Whether the result is a tuple of the child results instead of
+///               their concatenation.
+/// @tparam Ps The types of the child parsers.
+/// @note Created by `seq`, `seq_tuple` and `operator+`. The child results are
+///       kept until all children succeed, so a concatenated string is
+///       allocated once at its final size. On failure the iterator is left
+///       where the failing child stopped.
+template<bool Tuple, typename... Ps>
+struct seq_parser : parser_base {
+    std::tuple<Ps...> parsers;
+    first_set first_chars;
+
+    explicit seq_parser(std::tuple<Ps...> children)
+        : parsers(std::move(children)),
+          first_chars(std::apply([](const auto&... p) {
+              first_set first{char_class{}, true};
+              ((first = detail::first_of_sequence(first, first_of(p))), ...);
+              return first;
+          }, parsers)) {}
+
+    first_set first() const {
+        return first_chars;
+    }
+
+    template<CharIterator I, CharSentinel<I> S = null_sentinel>
+    auto try_parse(I& str_iter, S end = {}) const {
+        return run(str_iter, end, std::index_sequence_for<Ps...>{});
+    }
+
+    template<CharIterator I, CharSentinel<I> S = null_sentinel>
+    auto try_skip(I& str_iter, S end = {}) const -> parse_result<void> {
+        parse_result<void> result;
+        detail::cut_mark cut;
+        std::apply([&](const auto&... p) {
+            (static_cast<bool>(result = simparse::try_skip(p, str_iter, end)) && ...);
+        }, parsers);
+        cut.seal(result);
+        return result;
+    }
+
+    template<CharIterator I, CharSentinel<I> S = null_sentinel>
+    auto operator()(I& str_iter, S end = {}) const {
+        auto result = try_parse(str_iter, end);
+        if (!result) {
+            detail::raise_parse_error(result.error());
+        }
+        return std::move(*result);
+    }
+
+private:
+    template<typename I, typename S>
+    using value_t = std::conditional_t<Tuple,
+        std::tuple<parsed_t<Ps, I, S>...>,
+        detail::concat_fold_t<parsed_t<Ps, I, S>...>>;
+
+    template<CharIterator I, CharSentinel<I> S, std::size_t... Is>
+    auto run(I& str_iter, S end, std::index_sequence<Is...>) const -> parse_result<value_t<I, S>> {
+        using T = value_t<I, S>;
+        std::tuple<std::optional<parsed_t<Ps, I, S>>...> values;
+        parse_error error{nullptr};
+        detail::cut_mark cut;
+        bool ok = ([&] {
+            auto r = simparse::try_parse(std::get<Is>(parsers), str_iter, end);
+            cut.seal(r);
+            if (!r) {
+                error = r.error();
+                return false;
+            }
+            std::get<Is>(values).emplace(std::move(*r));
+            return true;
+        }() && ...);
+        if (!ok) {
+            return error;
+        }
+        if constexpr (Tuple) {
+            return T(std::move(*std::get<Is>(values))...);
+        } else if constexpr (std::same_as<T, input_view>) {
+            return input_view(std::get<0>(values)->data(), (std::get<Is>(values)->size() + ...));
+        } else if constexpr (std::same_as<T, std::string>) {
+            std::string result;
+            result.reserve((detail::value_size(*std::get<Is>(values)) + ...));
+            (detail::append_value(result, *std::get<Is>(values)), ...);
+            return result;
+        } else {
+            return detail::concat_values<T>(std::move(*std::get<Is>(values))...);
+        }
+    }
+};
+
+namespace detail {
+
+template<typename P>
+inline constexpr bool is_concat_seq_v = false;
+
+template<typename... Ps>
+inline constexpr bool is_concat_seq_v<seq_parser<false, Ps...>> = true;
+
+/// @brief The children a sequence gets from `parser`: its own children if it is
+///        a concatenating sequence, the held parser otherwise.
+template<typename P>
+auto seq_operands(P&& parser) {
+    if constexpr (is_concat_seq_v<std::remove_cvref_t<P>>) {
+        return std::forward<P>(parser).parsers;
+    } else {
+        return std::tuple<held_t<P>>(hold(std::forward<P>(parser)));
+    }
+}
+
+template<bool Tuple, typename... Ps>
+auto make_seq(std::tuple<Ps...> children) {
+    return seq_parser<Tuple, Ps...>(std::move(children));
+}
+
+}
+
+/// @brief Concatenates the results of the parsers, run one after another.
+/// @tparam Fs The types of the parsers.
+/// @param parsers The parsers, in order.
+/// @return A parser that returns the concatenation of the child results.
+/// @note Same result as `(p1 + p2 + ...)`. Two or more `input_view`
+///       results are merged into one view.
+template<typename... Fs>
+auto seq(Fs&&... parsers) {
+    return detail::make_seq<false>(std::tuple_cat(detail::seq_operands(std::forward<Fs>(parsers))...));
+}
+
+/// @brief Runs the parsers one after another and returns their results as a tuple.
+/// @tparam Fs The types of the parsers.
+/// @param parsers The parsers, in order.
+/// @return A parser that returns `std::tuple` of the child results.
+template<typename... Fs>
+auto seq_tuple(Fs&&... parsers) {
+    return seq_parser<true, detail::held_t<Fs>...>(
+        std::tuple<detail::held_t<Fs>...>(detail::hold(std::forward<Fs>(parsers))...));
 }
 
 /// @brief Concatenates the parsers.
@@ -161,65 +1798,368 @@ auto peek(F&& parser) {
 /// @return A parser function that concatenates the results of the two parsers.
 /// @note This parser will return the concatenated result of both parsers.
 ///       If either parser fails, it will throw an exception.
+///       Two `input_view` results are merged into a single view without copying.
+///       Chains such as `a + b + c` flatten into a single `seq(a, b, c)`.
 template<typename F, typename G>
+    requires Parser<F> || Parser<G>
 auto operator+(F&& f, G&& g) {
-    return [=]<CharIterator I>(I& str_iter) {
-        auto result = f(str_iter);
-        result += g(str_iter);
-        return result;
-    };
+    return seq(std::forward<F>(f), std::forward<G>(g));
 }
 
+/// @brief Tries the first parser, then the second one if the first fails.
+/// @tparam F The type of the first parser function.
+/// @tparam G The type of the second parser function.
+/// @param f The first parser function.
+/// @param g The second parser function.
+/// @return A parser function that returns the result of the first successful parser.
+/// @note The second parser starts where the first one stopped; wrap the first
+///       parser with `back` to retry from the same position. A fatal failure
+///       of the first parser is returned without trying the second.
 template<typename F, typename G>
+    requires Parser<F> || Parser<G>
 auto operator|(F&& f, G&& g) {
-    return [=]<CharIterator I>(I& str_iter) {
-        try {
-            return f(str_iter);
-        } catch (const std::runtime_error&) {
-            return g(str_iter);
+    return make_parser([=, f = detail::hold(f), g = detail::hold(g)]<CharIterator I, CharSentinel<I> S, typename M = parse_mode>(I& str_iter, S end, M = {}) {
+        detail::cut_mark cut;
+        auto result = detail::run_mode<M>(f, str_iter, end);
+        if (result || result.error().fatal) {
+            cut.close();
+            return result;
         }
+        auto other = detail::run_mode<M>(g, str_iter, end);
+        cut.close();
+        return other;
+    }, no_skip{}, detail::first_of_choice(first_of(f), first_of(g)));
+}
+
+/// @brief Returns the input consumed by the parser as a view into the source buffer.
+/// @tparam F The type of the parser function.
+/// @param parser The parser function to use.
+/// @return A parser function that returns an `input_view` of the consumed characters.
+/// @note Only available for contiguous iterators. The underlying parser runs without
+///       building its own result, so no allocation is made. The view is only valid
+///       while the source buffer is alive.
+template<typename F>
+auto view(F&& parser) {
+    return make_parser([=, parser = detail::hold(parser)]<CharIterator I, CharSentinel<I> S, typename M = parse_mode>(I& str_iter, S end, M = {})
+        -> detail::mode_result_t<M, input_view>
+        requires (M::skip || std::contiguous_iterator<I>) {
+        [[maybe_unused]] auto first = str_iter;
+        auto r = try_skip(parser, str_iter, end);
+        if constexpr (M::skip) {
+            return r;
+        } else {
+            if (!r) {
+                return r.error();
+            }
+            return input_view(std::to_address(first), static_cast<size_t>(str_iter - first));
+        }
+    }, no_skip{}, first_of(parser));
+}
+
+namespace detail {
+
+/// @brief The narrowest unsigned type with one bit per alternative.
+template<std::size_t N>
+using branch_mask_t =
+    std::conditional_t<N <= 8, std::uint8_t,
+    std::conditional_t<N <= 16, std::uint16_t,
+    std::conditional_t<N <= 32, std::uint32_t, std::uint64_t>>>;
+
+/// @brief Runs the alternative at `index` through a table of function pointers.
+template<typename T, bool Skip, typename Tuple, CharIterator I, CharSentinel<I> S, std::size_t... Is>
+auto run_branch(const Tuple& branches, std::size_t index, I& str_iter, S end, std::index_sequence<Is...>) {
+    using R = std::conditional_t<Skip, parse_result<void>, parse_result<T>>;
+    using fn_t = R (*)(const Tuple&, I&, S);
+    static constexpr fn_t table[] = {
+        [](const Tuple& b, I& it, S e) -> R {
+            if constexpr (Skip) {
+                return try_skip(std::get<Is>(b), it, e);
+            } else {
+                auto r = try_parse(std::get<Is>(b), it, e);
+                if (!r) {
+                    return r.error();
+                }
+                return T(std::move(*r));
+            }
+        }...
     };
+    return table[index](branches, str_iter, end);
+}
+
+}
+
+/// @brief Tries the alternatives that can start with the next character.
+/// @tparam Fs The types of the alternative parsers.
+/// @param parsers The alternative parsers, in order of priority.
+/// @return A parser function that returns the result of the first successful alternative.
+/// @note The first sets of the alternatives are compiled into a 256-entry table
+///       indexed by the next character, so only the viable alternatives run.
+///       Alternatives with disjoint first sets (e.g. keywords) resolve with a
+///       single lookup. Unlike `operator|`, every alternative starts from the
+///       same position, and the iterator is restored if all of them fail.
+///       A fatal failure stops the search and is returned as is.
+template<typename... Fs>
+auto alt(Fs&&... parsers) {
+    constexpr std::size_t N = sizeof...(Fs);
+    static_assert(N >= 1 && N <= 64, "alt() supports 1 to 64 alternatives.");
+    using mask_t = detail::branch_mask_t<N>;
+
+    std::tuple<detail::held_t<Fs>...> branches(detail::hold(std::forward<Fs>(parsers))...);
+    auto firsts = std::apply([](const auto&... p) { return std::array<first_set, N>{first_of(p)...}; }, branches);
+
+    std::array<mask_t, 256> table{};
+    mask_t nullable = 0;
+    first_set first{char_class{}, false};
+    for (std::size_t i = 0; i < N; ++i) {
+        auto bit = static_cast<mask_t>(mask_t{1} << i);
+        if (firsts[i].nullable) {
+            nullable |= bit;
+        }
+        for (unsigned c = 0; c < 256; ++c) {
+            if (firsts[i].viable(static_cast<char>(c))) {
+                table[c] |= bit;
+            }
+        }
+        first = detail::first_of_choice(first, firsts[i]);
+    }
+
+    return make_parser([=]<CharIterator I, CharSentinel<I> S, typename M = parse_mode>(I& str_iter, S end, M = {})
+        -> detail::mode_result_t<M, std::common_type_t<parsed_t<Fs, I, S>...>> {
+        using T = std::common_type_t<parsed_t<Fs, I, S>...>;
+        mask_t candidates = str_iter == end ? nullable : table[static_cast<unsigned char>(*str_iter)];
+        auto start = str_iter;
+        parse_error error{"No alternative matched."};
+        while (candidates != 0) {
+            auto index = static_cast<std::size_t>(std::countr_zero(candidates));
+            candidates &= static_cast<mask_t>(candidates - 1);
+            str_iter = start;
+            detail::cut_mark cut;
+            auto result = detail::run_branch<T, M::skip>(branches, index, str_iter, end, std::index_sequence_for<Fs...>{});
+            if (result || result.error().fatal) {
+                cut.close();
+                return result;
+            }
+            error = result.error();
+        }
+        str_iter = start;
+        return error;
+    }, no_skip{}, first);
 }
 
+/// @brief A reference to a rule, stored by the combinators that use the rule.
+template<typename Rule>
+struct rule_ref : parser_base {
+    const Rule* target;
+
+    template<CharIterator I, CharSentinel<I> S>
+    auto try_parse(I& str_iter, S end) const {
+        return target->try_parse(str_iter, end);
+    }
+
+    template<CharIterator I, CharSentinel<I> S>
+    auto try_skip(I& str_iter, S end) const {
+        return target->try_skip(str_iter, end);
+    }
+
+    template<CharIterator I, CharSentinel<I> S = null_sentinel>
+    auto operator()(I& str_iter, S end = {}) const {
+        return (*target)(str_iter, end);
+    }
+
+    first_set first() const {
+        return target->first();
+    }
+};
+
+/// @brief A named parser with a fixed signature that can be used before it is defined.
+/// @tparam I The type of the input iterator.
+/// @tparam R The type of the parsed value.
+/// @tparam S The type of the sentinel.
+/// @tparam Capacity The size of the inline storage for the definition, room for
+///         a small combinator by default.
+/// @note The definition is stored inline and called through one function
+///       pointer, so calling a rule never allocates. A definition larger than
+///       `Capacity` is allocated once, when the rule is defined; raise `Capacity`
+///       to keep a larger grammar inline. Combinators
+///       hold a rule by reference, which lets a rule appear in its own
+///       definition:
+///       @code
+///       rule<const char*, std::string> expr;
+///       expr = many(digit) | (string("(") + expr + string(")"));
+///       @endcode
+///       A rule is neither copyable nor movable, and must outlive the parsers
+///       built from it. With SIMPARSE_TRACE, a named rule shows up as a span in traces.
+template<CharIterator I, typename R, CharSentinel<I> S = null_sentinel, std::size_t Capacity = 128>
+class rule : public parser_base {
+public:
+    rule() = default;
+
+    /// @brief Creates a rule named `name`, which is recorded as a span around
+    ///        each parse while tracing (see SIMPARSE_TRACE).
+    /// @param name The name of the rule, a string literal or another string that
+    ///             outlives the rule.
+    explicit rule(const char* name) noexcept : name_(name) {}
+
+    /// @brief Creates a rule defined as `parser`.
+    template<typename P>
+        requires (!std::same_as<std::remove_cvref_t<P>, rule> && !std::convertible_to<P, const char*>)
+    rule(P&& parser) {
+        define(std::forward<P>(parser));
+    }
+
+    rule(const rule&) = delete;
+    rule& operator=(const rule&) = delete;
+
+    ~rule() {
+        reset();
+    }
+
+    /// @brief Defines the rule as `parser`, replacing any previous definition.
+    /// @note Another rule is held by reference, as by the combinators.
+    template<typename P>
+        requires (!std::same_as<std::remove_cvref_t<P>, rule> && !std::convertible_to<P, const char*>)
+    rule& operator=(P&& parser) {
+        reset();
+        define(std::forward<P>(parser));
+        return *this;
+    }
+
+    /// @brief Returns a reference to this rule, which is what combinators store.
+    rule_ref<rule> ref() const noexcept {
+        return {{}, this};
+    }
+
+    auto try_parse(I& str_iter, S end = {}) const -> parse_result<R> {
+        if (!parse_) {
+            return parse_error{"Rule is not defined."};
+        }
+        SIMPARSE_TRACE_SPAN(span, name_);
+        return parse_(storage_, str_iter, end);
+    }
+
+    auto try_skip(I& str_iter, S end = {}) const -> parse_result<void> {
+        if (!skip_) {
+            return parse_error{"Rule is not defined."};
+        }
+        SIMPARSE_TRACE_SPAN(span, name_);
+        return skip_(storage_, str_iter, end);
+    }
+
+    R operator()(I& str_iter, S end = {}) const {
+        auto result = try_parse(str_iter, end);
+        if (!result) {
+            detail::raise_parse_error(result.error());
+        }
+        return std::move(*result);
+    }
+
+    /// @brief The name given at construction, or null.
+    const char* name() const noexcept {
+        return name_;
+    }
+
+    /// @brief The first set of the definition when it was given.
+    /// @note Parsers built before the definition see first_set::unknown().
+    first_set first() const {
+        return first_;
+    }
+
+private:
+    using parse_fn = parse_result<R> (*)(const void*, I&, S);
+    using skip_fn = parse_result<void> (*)(const void*, I&, S);
+    using destroy_fn = void (*)(void*);
+
+    static_assert(Capacity >= sizeof(void*), "The rule needs room for a pointer.");
+
+    /// @brief Whether the definition T is stored in place; otherwise the
+    ///        storage holds a pointer to it.
+    template<typename T>
+    static constexpr bool fits_inline = sizeof(T) <= Capacity && alignof(T) <= alignof(std::max_align_t);
+
+    template<typename T>
+    static const T& stored(const void* p) {
+        if constexpr (fits_inline<T>) {
+            return *static_cast<const T*>(p);
+        } else {
+            return **static_cast<const T* const*>(p);
+        }
+    }
+
+    template<typename P>
+    void define(P&& parser) {
+        using T = detail::held_t<P>;
+        first_ = first_of(parser);
+        if constexpr (fits_inline<T>) {
+            ::new (static_cast<void*>(storage_)) T(detail::hold(std::forward<P>(parser)));
+        } else {
+            ::new (static_cast<void*>(storage_)) T*(new T(detail::hold(std::forward<P>(parser))));
+        }
+        parse_ = [](const void* p, I& str_iter, S end) -> parse_result<R> {
+            auto result = simparse::try_parse(stored<T>(p), str_iter, end);
+            if (!result) {
+                return result.error();
+            }
+            return R(std::move(*result));
+        };
+        skip_ = [](const void* p, I& str_iter, S end) {
+            return simparse::try_skip(stored<T>(p), str_iter, end);
+        };
+        destroy_ = [](void* p) {
+            if constexpr (fits_inline<T>) {
+                static_cast<T*>(p)->~T();
+            } else {
+                delete *static_cast<T**>(p);
+            }
+        };
+    }
+
+    void reset() noexcept {
+        if (destroy_) {
+            destroy_(storage_);
+        }
+        parse_ = nullptr;
+        skip_ = nullptr;
+        destroy_ = nullptr;
+        first_ = first_set::unknown();
+    }
+
+    alignas(std::max_align_t) std::byte storage_[Capacity];
+    parse_fn parse_ = nullptr;
+    skip_fn skip_ = nullptr;
+    destroy_fn destroy_ = nullptr;
+    first_set first_ = first_set::unknown();
+    const char* name_ = nullptr;
+};
+
 
 /// @brief Parses a single character from the input iterator.
 /// @tparam I The type of the input iterator.
 /// @param str_iter The input iterator to parse from.
 /// @return The parsed character.
-inline auto any_char = []<CharIterator I>(I& str_iter) -> char {
-    return satisfy([](auto) { return true; })(str_iter);
-}; 
+inline constexpr class_parser any_char{char_class::all()};
 
 /// @brief Parses a single digit character from the input iterator.
 /// @tparam I The type of the input iterator.
 /// @param str_iter The input iterator to parse from.
 /// @return The parsed digit character.
-inline auto digit = []<CharIterator I>(I& str_iter) -> char {
-    return satisfy([](char c) { return std::isdigit(c); })(str_iter);
-};
+inline constexpr class_parser digit{char_class::range('0', '9')};
 
 /// @brief Parses a single alphabet character from the input iterator.
 /// @tparam I The type of the input iterator.
 /// @param str_iter The input iterator to parse from.
 /// @return The parsed alphabet character.
-inline auto alphabet = []<CharIterator I>(I& str_iter) -> char {
-    return satisfy([](char c) { return std::isalpha(c); })(str_iter);
-};
+inline constexpr class_parser alphabet{char_class::range('A', 'Z') | char_class::range('a', 'z')};
 
 /// @brief Parses a single alphanumeric character from the input iterator.
 /// @tparam I The type of the input iterator.
 /// @param str_iter The input iterator to parse from.
 /// @return The parsed alphanumeric character.
-inline auto alphanumeric = []<CharIterator I>(I& str_iter) -> char {
-    return satisfy([](char c) { return std::isalnum(c); })(str_iter);
-};
+inline constexpr class_parser alphanumeric{digit | alphabet};
 
 /// @brief Parses a single whitespace character from the input iterator.
 /// @tparam I The type of the input iterator.
 /// @param str_iter The input iterator to parse from.
 /// @return The parsed whitespace character.
-inline auto whitespace = []<CharIterator I>(I& str_iter) -> char {
-    return satisfy([](char c) { return std::isspace(c); })(str_iter);
-};
+inline constexpr class_parser whitespace{char_class::of(" \t\n\v\f\r")};
 
 }
\ No newline at end of file
@@ -0,0 +1,203 @@
+#pragma once
+
+#include "simparse.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <iomanip>
+#include <iterator>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/// @brief Enables the named probes of `simparse::probe`. Off by default: a probe is
+///        then the wrapped parser itself and the report functions do nothing.
+#if !defined(SIMPARSE_INSTRUMENT)
+#define SIMPARSE_INSTRUMENT 0
+#endif
+
+namespace simparse {
+
+/// @brief The counters of one named probe.
+struct probe_record {
+    std::string name;
+    /// @brief The number of times the probed parser was run, and how they ended.
+    std::uint64_t calls = 0;
+    std::uint64_t successes = 0;
+    std::uint64_t failures = 0;
+    /// @brief The input consumed by successful runs, in characters.
+    std::uint64_t consumed = 0;
+    /// @brief The input read by failed runs before they failed, in characters.
+    ///        This is what an enclosing `back`, `|` or `alt` rewinds.
+    std::uint64_t backtracked = 0;
+    /// @brief The time spent in the parser, including nested probes, in TSC cycles
+    ///        (nanoseconds on targets without a time-stamp counter).
+    std::uint64_t cycles = 0;
+};
+
+// The two configurations live in different inline namespaces, so translation units
+// built with and without SIMPARSE_INSTRUMENT can be linked together.
+#if SIMPARSE_INSTRUMENT
+namespace detail {
+
+inline std::uint64_t probe_clock() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+/// @brief The live counters of a probe, updated with relaxed atomics.
+struct probe_counters {
+    explicit probe_counters(std::string_view name) : name(name) {}
+
+    std::string name;
+    std::atomic<std::uint64_t> calls{0};
+    std::atomic<std::uint64_t> successes{0};
+    std::atomic<std::uint64_t> failures{0};
+    std::atomic<std::uint64_t> consumed{0};
+    std::atomic<std::uint64_t> backtracked{0};
+    std::atomic<std::uint64_t> cycles{0};
+
+    void record(bool success, std::uint64_t bytes, std::uint64_t elapsed) {
+        calls.fetch_add(1, std::memory_order_relaxed);
+        (success ? successes : failures).fetch_add(1, std::memory_order_relaxed);
+        (success ? consumed : backtracked).fetch_add(bytes, std::memory_order_relaxed);
+        cycles.fetch_add(elapsed, std::memory_order_relaxed);
+    }
+};
+
+/// @brief The probes of the process, by name. Probes with the same name share counters.
+class probe_registry {
+public:
+    static probe_registry& instance() {
+        static probe_registry registry;
+        return registry;
+    }
+
+    probe_counters& get(std::string_view name) {
+        std::lock_guard lock(mutex_);
+        for (auto& probe : probes_) {
+            if (probe.name == name) {
+                return probe;
+            }
+        }
+        return probes_.emplace_back(name);
+    }
+
+    std::vector<probe_record> records() {
+        std::lock_guard lock(mutex_);
+        std::vector<probe_record> result;
+        for (const auto& p : probes_) {
+            result.push_back({p.name, p.calls.load(std::memory_order_relaxed),
+                              p.successes.load(std::memory_order_relaxed), p.failures.load(std::memory_order_relaxed),
+                              p.consumed.load(std::memory_order_relaxed), p.backtracked.load(std::memory_order_relaxed),
+                              p.cycles.load(std::memory_order_relaxed)});
+        }
+        return result;
+    }
+
+    void reset() {
+        std::lock_guard lock(mutex_);
+        for (auto& p : probes_) {
+            for (auto* counter : {&p.calls, &p.successes, &p.failures, &p.consumed, &p.backtracked, &p.cycles}) {
+                counter->store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    std::mutex mutex_;
+    std::deque<probe_counters> probes_;
+};
+
+}
+
+inline namespace probes_enabled {
+
+/// @brief Wraps the parser with a named probe that counts its runs.
+/// @tparam F The type of the parser function.
+/// @param name The name of the probe in the report.
+/// @param parser The parser function to observe.
+/// @return A parser function that returns the result of the given parser.
+/// @note Records calls, successes, failures, consumed and backtracked characters
+///       and cycles. Put the probe inside a `back` to see the input it rewinds,
+///       e.g. `back(probe("zone", zone))`. Without SIMPARSE_INSTRUMENT this
+///       returns the parser itself.
+template<typename F>
+auto probe(std::string_view name, F&& parser) {
+    auto* counters = &detail::probe_registry::instance().get(name);
+    return make_parser([=, parser = detail::hold(parser)]<CharIterator I, CharSentinel<I> S, typename M = parse_mode>(I& str_iter, S end, M = {}) {
+        auto start = detail::probe_clock();
+        auto first = str_iter;
+        auto result = detail::run_mode<M>(parser, str_iter, end);
+        auto bytes = static_cast<std::uint64_t>(std::distance(first, str_iter));
+        counters->record(static_cast<bool>(result), bytes, detail::probe_clock() - start);
+        return result;
+    }, no_skip{}, first_of(parser));
+}
+
+/// @brief The counters of every probe, sorted by descending cycles.
+inline std::vector<probe_record> probe_records() {
+    auto records = detail::probe_registry::instance().records();
+    std::stable_sort(records.begin(), records.end(), [](const auto& a, const auto& b) { return a.cycles > b.cycles; });
+    return records;
+}
+
+/// @brief Sets the counters of every probe to zero.
+inline void reset_probes() {
+    detail::probe_registry::instance().reset();
+}
+
+/// @brief Writes a table of the probes, sorted by descending cycles.
+inline void write_probe_report(std::ostream& out) {
+    auto records = probe_records();
+    std::size_t width = 5;
+    for (const auto& r : records) {
+        width = std::max(width, r.name.size());
+    }
+    out << std::left << std::setw(static_cast<int>(width)) << "probe" << std::right
+        << std::setw(12) << "calls" << std::setw(12) << "successes" << std::setw(12) << "failures"
+        << std::setw(14) << "consumed" << std::setw(14) << "backtracked"
+        << std::setw(16) << "cycles" << std::setw(12) << "cycles/call" << '\n';
+    for (const auto& r : records) {
+        out << std::left << std::setw(static_cast<int>(width)) << r.name << std::right
+            << std::setw(12) << r.calls << std::setw(12) << r.successes << std::setw(12) << r.failures
+            << std::setw(14) << r.consumed << std::setw(14) << r.backtracked
+            << std::setw(16) << r.cycles << std::setw(12) << (r.calls ? r.cycles / r.calls : 0) << '\n';
+    }
+}
+
+}
+#else
+inline namespace probes_disabled {
+
+template<typename F>
+auto probe(std::string_view, F&& parser) {
+    return detail::hold(std::forward<F>(parser));
+}
+
+inline std::vector<probe_record> probe_records() {
+    return {};
+}
+
+inline void reset_probes() {}
+
+inline void write_probe_report(std::ostream&) {}
+
+}
+#endif
+
+}
\ No newline at end of file
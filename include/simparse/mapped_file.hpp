@@ -0,0 +1,146 @@
+#pragma once
+
+#include "simparse.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace simparse {
+
+/// @brief A read-only memory mapping of a whole file.
+/// @details The mapping is a contiguous range of `const char`, so every combinator,
+///          including `view()`, parses it in place without copying it into a
+///          `std::string` first. Views returned by the parsers point into the
+///          mapping and must not outlive it.
+class mapped_file {
+public:
+    /// @brief The access pattern announced to the kernel.
+    enum class advice {
+        normal = MADV_NORMAL,
+        sequential = MADV_SEQUENTIAL,
+        random = MADV_RANDOM,
+        willneed = MADV_WILLNEED,
+        dontneed = MADV_DONTNEED,
+    };
+
+    mapped_file() = default;
+
+    /// @brief Maps the file at `path`.
+    /// @param path The path of the file.
+    /// @param hint The access pattern of the whole mapping. Sequential parsing
+    ///             also prefetches the file with `MADV_WILLNEED`.
+    /// @note Throws std::system_error when the file cannot be opened or mapped.
+    explicit mapped_file(const std::string& path, advice hint = advice::sequential) {
+        const char* call = nullptr;
+        if (auto ec = map(path, hint, call)) {
+            detail::raise<std::system_error>(ec, std::string(call) + " " + path);
+        }
+    }
+
+    /// @brief Maps the file at `path`, reporting a failure through `ec` instead of
+    ///        throwing. The mapping is empty on failure.
+    /// @note This is the interface to use without exceptions (see SIMPARSE_EXCEPTIONS).
+    mapped_file(const std::string& path, std::error_code& ec, advice hint = advice::sequential) {
+        const char* call = nullptr;
+        ec = map(path, hint, call);
+    }
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    mapped_file(mapped_file&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)) {}
+
+    mapped_file& operator=(mapped_file&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+        }
+        return *this;
+    }
+
+    ~mapped_file() { unmap(); }
+
+    /// @brief Announces the access pattern of [offset, offset + length) to the kernel.
+    /// @note The range is widened to page boundaries. Hints are best effort and
+    ///       failures are ignored.
+    void advise(advice hint, std::size_t offset = 0, std::size_t length = std::string_view::npos) const {
+        if (!data_ || offset >= size_) {
+            return;
+        }
+        length = std::min(length, size_ - offset);
+        auto page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        auto first = offset / page * page;
+        ::madvise(const_cast<char*>(data_) + first, length + (offset - first), static_cast<int>(hint));
+    }
+
+    const char* data() const noexcept { return data_; }
+    std::size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+    const char* begin() const noexcept { return data_; }
+    const char* end() const noexcept { return data_ + size_; }
+
+    /// @brief The whole mapping as a string view.
+    std::string_view view() const noexcept { return {data_, size_}; }
+
+private:
+    /// @brief Maps the file, returning the error of the failed system call `call`.
+    std::error_code map(const std::string& path, advice hint, const char*& call) noexcept {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            call = "open";
+            return {errno, std::generic_category()};
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            int err = errno;
+            ::close(fd);
+            call = "fstat";
+            return {err, std::generic_category()};
+        }
+        size_ = static_cast<std::size_t>(st.st_size);
+        if (size_ > 0) {
+            void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr == MAP_FAILED) {
+                int err = errno;
+                ::close(fd);
+                size_ = 0;
+                call = "mmap";
+                return {err, std::generic_category()};
+            }
+            data_ = static_cast<const char*>(addr);
+        }
+        ::close(fd);
+
+        advise(hint);
+        if (hint == advice::sequential) {
+            advise(advice::willneed);
+        }
+        return {};
+    }
+
+    void unmap() noexcept {
+        if (data_) {
+            ::munmap(const_cast<char*>(data_), size_);
+        }
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+}
\ No newline at end of file
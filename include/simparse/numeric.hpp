@@ -0,0 +1,427 @@
+#pragma once
+
+#include "simparse.hpp"
+
+#include <bit>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <system_error>
+
+namespace simparse {
+
+namespace detail {
+
+/// @brief The longest numeric token converted through the stack buffer.
+inline constexpr std::size_t max_number_length = 128;
+
+/// @brief Collects the normalized characters of a numeric token.
+/// @note `Copy` is false for the in-place pass, which only records whether the
+///       token must be rewritten before `std::from_chars` can read it.
+template<bool Copy>
+struct number_sink {
+    char buffer[Copy ? max_number_length : 1];
+    std::size_t size = 0;
+    bool rewritten = false;
+
+    void put(char c) {
+        if constexpr (Copy) {
+            if (size < max_number_length) {
+                buffer[size] = c;
+            }
+        }
+        ++size;
+    }
+
+    bool overflow() const {
+        return Copy && size > max_number_length;
+    }
+};
+
+/// @brief Whether the character at `str_iter` is a decimal digit.
+template<CharIterator I, CharSentinel<I> S>
+bool at_digit(const I& str_iter, S end) {
+    return str_iter != end && *str_iter >= '0' && *str_iter <= '9';
+}
+
+/// @brief Scans `[+-]digits` into the sink.
+/// @return Whether at least one digit was found.
+template<bool Signed, CharIterator I, CharSentinel<I> S, bool Copy>
+bool scan_integer(I& str_iter, S end, number_sink<Copy>& sink) {
+    if (str_iter != end && *str_iter == '+') {
+        sink.rewritten = true;
+        ++str_iter;
+    } else if (Signed && str_iter != end && *str_iter == '-') {
+        sink.put('-');
+        ++str_iter;
+    }
+    if (!at_digit(str_iter, end)) {
+        return false;
+    }
+    while (at_digit(str_iter, end)) {
+        sink.put(*str_iter);
+        ++str_iter;
+    }
+    return true;
+}
+
+/// @brief Scans a real number into the sink, rewriting it into the syntax of `std::from_chars`.
+/// @note Accepts `[+-]digits[.digits][exponent]` and `[+-].digits[exponent]`.
+///       The exponent may be introduced by `e`, `E`, `d` or `D` (Fortran), or
+///       directly by its sign as in `1.0-05` (Tecplot).
+/// @return Whether a number was found.
+template<CharIterator I, CharSentinel<I> S, bool Copy>
+bool scan_real(I& str_iter, S end, number_sink<Copy>& sink) {
+    if (str_iter != end && *str_iter == '+') {
+        sink.rewritten = true;
+        ++str_iter;
+    } else if (str_iter != end && *str_iter == '-') {
+        sink.put('-');
+        ++str_iter;
+    }
+    std::size_t digits = 0;
+    while (at_digit(str_iter, end)) {
+        sink.put(*str_iter);
+        ++str_iter;
+        ++digits;
+    }
+    if (str_iter != end && *str_iter == '.') {
+        sink.put('.');
+        ++str_iter;
+        while (at_digit(str_iter, end)) {
+            sink.put(*str_iter);
+            ++str_iter;
+            ++digits;
+        }
+    }
+    if (digits == 0) {
+        return false;
+    }
+
+    // The exponent is only consumed when it has at least one digit.
+    if (str_iter == end) {
+        return true;
+    }
+    auto it = str_iter;
+    char marker = *it;
+    bool has_marker = marker == 'e' || marker == 'E' || marker == 'd' || marker == 'D';
+    if (!has_marker && marker != '+' && marker != '-') {
+        return true;
+    }
+    if (has_marker) {
+        ++it;
+    }
+    char sign = '\0';
+    if (it != end && (*it == '+' || *it == '-')) {
+        sign = *it;
+        ++it;
+    }
+    if (!at_digit(it, end)) {
+        return true;
+    }
+    sink.put('e');
+    sink.rewritten |= marker != 'e' && marker != 'E';
+    if (sign != '\0') {
+        sink.put(sign);
+    }
+    while (at_digit(it, end)) {
+        sink.put(*it);
+        ++it;
+    }
+    str_iter = it;
+    return true;
+}
+
+/// @brief Converts the token [first, last) with `std::from_chars`.
+template<typename T>
+parse_result<T> convert_number(const char* first, const char* last) {
+    T value{};
+    auto [ptr, ec] = std::from_chars(first, last, value);
+    if (ec == std::errc::result_out_of_range) {
+        return parse_error{"Number out of range."};
+    }
+    if (ec != std::errc{} || ptr != last) {
+        return parse_error{"Invalid number."};
+    }
+    return value;
+}
+
+/// @brief Scans a numeric token with `scan` and converts it to T.
+/// @note On contiguous input the token is converted in place unless it has to
+///       be rewritten; otherwise it is copied into a stack buffer. The
+///       iterator is left unchanged on failure.
+template<typename T, CharIterator I, CharSentinel<I> S, typename Scan>
+parse_result<T> parse_number(I& str_iter, S end, Scan scan) {
+    auto start = str_iter;
+    if constexpr (std::contiguous_iterator<I>) {
+        number_sink<false> probe;
+        if (!scan(str_iter, end, probe)) {
+            str_iter = start;
+            return parse_error{"Number expected."};
+        }
+        if (!probe.rewritten) {
+            auto result = convert_number<T>(std::to_address(start), std::to_address(str_iter));
+            if (!result) {
+                str_iter = start;
+            }
+            return result;
+        }
+        str_iter = start;
+    }
+    number_sink<true> sink;
+    if (!scan(str_iter, end, sink)) {
+        str_iter = start;
+        return parse_error{"Number expected."};
+    }
+    if (sink.overflow()) {
+        str_iter = start;
+        return parse_error{"Number too long."};
+    }
+    auto result = convert_number<T>(sink.buffer, sink.buffer + sink.size);
+    if (!result) {
+        str_iter = start;
+    }
+    return result;
+}
+
+}
+
+/// @brief Creates a parser for a decimal integer.
+/// @tparam T The integer type to produce.
+/// @return A parser function that returns the parsed value.
+/// @note Accepts an optional sign (only `+` for unsigned types) followed by digits.
+///       The value is converted with `std::from_chars` directly from contiguous
+///       input, without building a string. If the token is not a valid number
+///       or does not fit in T, the iterator is not modified.
+template<std::integral T = int>
+auto integer() {
+    return make_parser([]<CharIterator I, CharSentinel<I> S>(I& str_iter, S end) -> parse_result<T> {
+        return detail::parse_number<T>(str_iter, end, []<bool Copy>(I& it, S e, detail::number_sink<Copy>& sink) {
+            return detail::scan_integer<std::is_signed_v<T>>(it, e, sink);
+        });
+    }, no_skip{}, first_set{char_class::range('0', '9') | char_class::of(std::is_signed_v<T> ? "+-" : "+"), false});
+}
+
+/// @brief Creates a parser for a real number.
+/// @tparam T The floating-point type to produce.
+/// @return A parser function that returns the parsed value.
+/// @note Accepts `[+-]digits[.digits][exponent]` and `[+-].digits[exponent]`,
+///       where the exponent is introduced by `e`, `E`, `d`, `D`, or directly by
+///       its sign as in Tecplot's `1.0-05`. Plain tokens are converted with
+///       `std::from_chars` in place; the others are rewritten in a stack buffer.
+///       If the token is not a valid number, the iterator is not modified.
+template<std::floating_point T = double>
+auto real() {
+    return make_parser([]<CharIterator I, CharSentinel<I> S>(I& str_iter, S end) -> parse_result<T> {
+        return detail::parse_number<T>(str_iter, end, []<bool Copy>(I& it, S e, detail::number_sink<Copy>& sink) {
+            return detail::scan_real(it, e, sink);
+        });
+    }, no_skip{}, first_set{char_class::range('0', '9') | char_class::of("+-."), false});
+}
+
+namespace detail {
+
+/// @brief Loads 8 bytes so that the first character is the lowest byte.
+inline std::uint64_t load_le64(const char* p) {
+    std::uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    if constexpr (std::endian::native == std::endian::big) {
+        v = __builtin_bswap64(v);
+    }
+    return v;
+}
+
+/// @brief Returns the number of leading digits in 8 bytes already xor-ed with '0'.
+/// @note A byte is a digit iff it is below 10 after the xor. Adding 0x76
+///       sets the high bit of every byte above 9; carries only leave bytes
+///       that are already flagged, so the lowest flagged byte is exact.
+inline unsigned leading_digits(std::uint64_t x) {
+    auto stop = ((x + 0x7676767676767676) | x) & 0x8080808080808080;
+    return stop == 0 ? 8 : static_cast<unsigned>(std::countr_zero(stop)) / 8;
+}
+
+/// @brief Converts 8 digit values (first digit in the lowest byte) with three multiplications.
+inline std::uint64_t parse_eight_digits(std::uint64_t x) {
+    x = (x * 10) + (x >> 8);
+    return (((x & 0x000000FF000000FF) * (100 + (1000000ULL << 32)))
+            + (((x >> 16) & 0x000000FF000000FF) * (1 + (10000ULL << 32)))) >> 32;
+}
+
+inline constexpr std::uint64_t pow10_table[] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000,
+};
+
+/// @brief Parses one integer at `p` eight digits at a time.
+/// @param padding The number of readable bytes past `last`.
+/// @return The end of the integer, or nullptr if there is none or it does not fit in T.
+template<std::integral T>
+const char* parse_integer_swar(const char* p, const char* last, std::size_t padding, T& out) {
+    bool negative = false;
+    if (*p == '+') {
+        ++p;
+    } else if (std::is_signed_v<T> && *p == '-') {
+        negative = true;
+        ++p;
+    }
+    // Leading zeros do not count towards the digits that must fit.
+    bool zeros = false;
+    while (p < last && *p == '0') {
+        zeros = true;
+        ++p;
+    }
+    std::uint64_t value = 0;
+    unsigned digits = 0;
+    while (p < last) {
+        auto available = static_cast<std::size_t>(last - p);
+        unsigned n;
+        std::uint64_t chunk;
+        if (available + padding >= 8) {
+            auto x = load_le64(p) ^ 0x3030303030303030;
+            n = std::min<unsigned>(leading_digits(x), static_cast<unsigned>(std::min<std::size_t>(available, 8)));
+            if (n == 0) {
+                break;
+            }
+            chunk = parse_eight_digits(n == 8 ? x : x << (8 * (8 - n)));
+        } else {
+            n = 0;
+            chunk = 0;
+            while (n < available && p[n] >= '0' && p[n] <= '9') {
+                chunk = chunk * 10 + static_cast<std::uint64_t>(p[n] - '0');
+                ++n;
+            }
+            if (n == 0) {
+                break;
+            }
+        }
+        // 19 digits always fit in 64 bits; a 20th may overflow.
+        if (digits + n <= std::numeric_limits<std::uint64_t>::digits10) {
+            value = value * pow10_table[n] + chunk;
+        } else if (digits + n > std::numeric_limits<std::uint64_t>::digits10 + 1
+                   || __builtin_mul_overflow(value, pow10_table[n], &value)
+                   || __builtin_add_overflow(value, chunk, &value)) {
+            return nullptr;
+        }
+        digits += n;
+        p += n;
+        if (n < 8) {
+            break;
+        }
+    }
+    if (digits == 0 && !zeros) {
+        return nullptr;
+    }
+    using U = std::make_unsigned_t<T>;
+    auto limit = static_cast<std::uint64_t>(std::numeric_limits<T>::max()) + (negative ? 1 : 0);
+    if (value > limit) {
+        return nullptr;
+    }
+    out = negative ? static_cast<T>(U{0} - static_cast<U>(value)) : static_cast<T>(value);
+    return p;
+}
+
+}
+
+/// @brief Creates a parser that fills `out` with whitespace-separated integers.
+/// @tparam T The integer type of the destination.
+/// @param out The destination; exactly `out.size()` integers are parsed.
+/// @return A parser function that returns the number of integers written.
+/// @note Whitespace before every integer is skipped. On contiguous input the
+///       digits are converted eight at a time with SWAR multiply-adds and the
+///       whitespace runs are found with the SIMD class scan; no string is
+///       built. Null-terminated input is scanned one token at a time, so the
+///       rest of the buffer is not measured. On failure the iterator points at the malformed token and the
+///       integers before it have been written.
+template<std::integral T>
+auto integer_list(std::span<T> out) {
+    return make_parser([=]<CharIterator I, CharSentinel<I> S>(I& str_iter, S end) -> parse_result<std::size_t> {
+        SIMPARSE_TRACE_SPAN(span, "integer_list", out.size());
+        if constexpr (class_parser::can_scan<I, S> && std::same_as<S, null_sentinel>) {
+            // Every token is bounded by its own terminated scan, so the rest of the
+            // buffer is never measured. The byte after the token is readable.
+            const char* p = std::to_address(str_iter);
+            for (std::size_t i = 0; i < out.size(); ++i) {
+                p = detail::scan_class_terminated(*whitespace.ranges, p);
+                const char* token = p + (*p == '+' || *p == '-');
+                const char* last = detail::scan_class_terminated(*digit.ranges, token);
+                const char* next = *p != '\0' ? detail::parse_integer_swar(p, last, 1, out[i]) : nullptr;
+                if (next == nullptr) {
+                    str_iter += p - std::to_address(str_iter);
+                    return parse_error{"Integer expected."};
+                }
+                p = next;
+            }
+            str_iter += p - std::to_address(str_iter);
+            return out.size();
+        } else if constexpr (class_parser::can_scan<I, S>) {
+            const char* last;
+            std::size_t padding = 0;
+            if constexpr (std::same_as<S, I>) {
+                last = std::to_address(end);
+            } else {
+                last = std::to_address(end.end);
+                padding = detail::padding_v<S>;
+            }
+            const char* p = std::to_address(str_iter);
+            for (std::size_t i = 0; i < out.size(); ++i) {
+                p = detail::scan_class(*whitespace.ranges, p, last, padding);
+                const char* next = p < last ? detail::parse_integer_swar(p, last, padding, out[i]) : nullptr;
+                if (next == nullptr) {
+                    str_iter += p - std::to_address(str_iter);
+                    return parse_error{"Integer expected."};
+                }
+                p = next;
+            }
+            str_iter += p - std::to_address(str_iter);
+            return out.size();
+        } else {
+            auto blanks = many(whitespace);
+            auto value = integer<T>();
+            for (std::size_t i = 0; i < out.size(); ++i) {
+                blanks.try_skip(str_iter, end);
+                auto r = value.try_parse(str_iter, end);
+                if (!r) {
+                    return r.error();
+                }
+                out[i] = *r;
+            }
+            return out.size();
+        }
+    }, no_skip{}, first_set{whitespace.cls | char_class::range('0', '9') | char_class::of("+-"), out.empty()});
+}
+
+/// @brief Creates a parser that fills `out` with reals separated by whitespace or commas.
+/// @tparam T The floating-point type of the destination.
+/// @param out The destination; exactly `out.size()` values are parsed.
+/// @return A parser function that returns the number of values written.
+/// @note Whitespace before the first value is skipped; between values the
+///       separator is whitespace with at most one comma. Values are converted
+///       as by `real<T>()`, so the loop builds no string and throws nothing.
+///       On failure the iterator points at the first malformed token, which
+///       gives its offset, and the values before it have been written.
+template<std::floating_point T>
+auto values_into(std::span<T> out) {
+    return make_parser([=]<CharIterator I, CharSentinel<I> S>(I& str_iter, S end) -> parse_result<std::size_t> {
+        SIMPARSE_TRACE_SPAN(span, "values_into", out.size());
+        auto blanks = many(whitespace);
+        auto value = real<T>();
+        for (std::size_t i = 0; i < out.size(); ++i) {
+            blanks.try_skip(str_iter, end);
+            if (i > 0 && str_iter != end && *str_iter == ',') {
+                ++str_iter;
+                blanks.try_skip(str_iter, end);
+            }
+            auto r = value.try_parse(str_iter, end);
+            if (!r) {
+                return r.error();
+            }
+            out[i] = *r;
+        }
+        return out.size();
+    }, no_skip{}, first_set{whitespace.cls | char_class::range('0', '9') | char_class::of("+-."), out.empty()});
+}
+
+}
\ No newline at end of file
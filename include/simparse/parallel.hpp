@@ -0,0 +1,155 @@
+#pragma once
+
+#include "simparse.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+namespace simparse {
+
+/// @brief Tuning knobs of the parallel drivers.
+struct parallel_options {
+    /// @brief Characters skipped between two elements.
+    char_class separators = whitespace.cls;
+    /// @brief Characters a chunk may start at. Elements must never contain them.
+    /// @note Use `char_class::of('\n')` when an element spans several tokens.
+    char_class boundaries = whitespace.cls;
+    /// @brief The target size of a chunk in bytes.
+    std::size_t chunk_size = std::size_t{1} << 20;
+};
+
+namespace detail {
+
+/// @brief The number of threads a parallel region will use.
+inline std::size_t max_threads() {
+#if defined(_OPENMP)
+    return static_cast<std::size_t>(omp_get_max_threads());
+#else
+    return 1;
+#endif
+}
+
+/// @brief Splits [first, last) into chunks starting at boundary characters.
+/// @return The chunk edges; chunk i is [edges[i], edges[i + 1]).
+inline std::vector<const char*> split_chunks(const char* first, const char* last, const parallel_options& options) {
+    auto size = static_cast<std::size_t>(last - first);
+    auto chunk_size = options.chunk_size == 0 ? size : options.chunk_size;
+    auto count = std::max<std::size_t>(1, (size + chunk_size - 1) / std::max<std::size_t>(1, chunk_size));
+    // Oversubscribe slightly so dynamic scheduling can even out dense chunks.
+    count = std::max(count, std::min(size / 64 + 1, 4 * max_threads()));
+
+    std::vector<const char*> edges{first};
+    for (std::size_t i = 1; i < count; ++i) {
+        auto p = std::max(first + size * i / count, edges.back());
+        while (p != last && !options.boundaries.contains(*p)) {
+            ++p;
+        }
+        if (p != edges.back()) {
+            edges.push_back(p);
+        }
+    }
+    if (edges.back() != last) {
+        edges.push_back(last);
+    }
+    return edges;
+}
+
+}
+
+/// @brief Parses every element of a contiguous buffer on all available threads.
+/// @details The buffer is split into chunks at `options.boundaries`, each chunk is
+///          parsed as a separator-delimited run of `element`, and the per-chunk
+///          results are concatenated in input order.
+/// @tparam P The type of the element parser. It is shared between threads and must
+///           not hold mutable state.
+/// @param str_iter The beginning of the buffer. On success it is moved to `last`; on
+///                 failure it points at the first element that could not be parsed.
+/// @param last The end of the buffer.
+/// @param element The element parser.
+/// @param options The separators, chunk boundaries and chunk size.
+/// @return The parsed elements in input order, or the error of the first failure.
+/// @note While tracing, records the spans `parallel_many`, `split_chunks`,
+///       `parse_chunk` (with the chunk index) and `stitch`.
+template<Parser P>
+auto parallel_many(const char*& str_iter, const char* last, const P& element, const parallel_options& options = {})
+    -> parse_result<std::vector<parsed_t<P, const char*, const char*>>>
+{
+    using T = parsed_t<P, const char*, const char*>;
+
+    struct chunk_state {
+        std::vector<T> values;
+        const char* failed = nullptr;
+        parse_error error{nullptr};
+    };
+
+    SIMPARSE_TRACE_SPAN(total, "parallel_many");
+    std::vector<const char*> edges;
+    {
+        SIMPARSE_TRACE_SPAN(span, "split_chunks");
+        edges = detail::split_chunks(str_iter, last, options);
+    }
+    auto count = static_cast<std::ptrdiff_t>(edges.size() - 1);
+    std::vector<chunk_state> chunks(edges.size() - 1);
+    auto separators = class_parser(options.separators);
+
+#if defined(_OPENMP)
+    #pragma omp parallel for schedule(dynamic, 1)
+#endif
+    for (std::ptrdiff_t i = 0; i < count; ++i) {
+        SIMPARSE_TRACE_SPAN(span, "parse_chunk", static_cast<std::uint64_t>(i));
+        auto& chunk = chunks[i];
+        const char* p = edges[i];
+        const char* end = edges[i + 1];
+        while (true) {
+            separators.scan(p, end);
+            if (p == end) {
+                break;
+            }
+            auto start = p;
+            auto r = try_parse(element, p, end);
+            if (!r || p == start) {
+                chunk.failed = start;
+                chunk.error = r ? parse_error{"Element parser made no progress."} : r.error();
+                break;
+            }
+            chunk.values.push_back(std::move(*r));
+        }
+    }
+
+    std::vector<std::size_t> offsets(chunks.size() + 1, 0);
+    for (std::size_t i = 0; i < chunks.size(); ++i) {
+        if (chunks[i].failed) {
+            str_iter = chunks[i].failed;
+            return chunks[i].error;
+        }
+        offsets[i + 1] = offsets[i] + chunks[i].values.size();
+    }
+
+    SIMPARSE_TRACE_SPAN(stitch, "stitch");
+    std::vector<T> result;
+    if constexpr (std::is_default_constructible_v<T>) {
+        result.resize(offsets.back());
+#if defined(_OPENMP)
+        #pragma omp parallel for schedule(dynamic, 1)
+#endif
+        for (std::ptrdiff_t i = 0; i < count; ++i) {
+            std::move(chunks[i].values.begin(), chunks[i].values.end(), result.begin() + offsets[i]);
+        }
+    } else {
+        result.reserve(offsets.back());
+        for (auto& chunk : chunks) {
+            std::move(chunk.values.begin(), chunk.values.end(), std::back_inserter(result));
+        }
+    }
+    str_iter = last;
+    return result;
+}
+
+}
\ No newline at end of file
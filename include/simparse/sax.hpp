@@ -0,0 +1,81 @@
+#pragma once
+
+#include "simparse.hpp"
+#include "simparse/numeric.hpp"
+
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+
+/// @brief Event parsers that report what they match to a handler instead of
+///        accumulating it into the result.
+/// @details The handler receives `on_token(kind, span)` for the input matched by a
+///          `token` parser and `on_value(value)` for every number parsed by a
+///          `value` parser. Combined with `ignore`, `many` and `try_skip`, a whole
+///          file can be scanned in constant memory: the event parsers return empty
+///          strings, which never allocate, and they still report when skipped.
+namespace simparse::sax {
+
+/// @brief Reports the input matched by the parser as `handler.on_token(kind, span)`.
+/// @tparam H The type of the handler.
+/// @tparam K The type of the token kind, e.g. an enum of the grammar.
+/// @tparam F The type of the parser function.
+/// @param handler The handler, which must outlive the parser.
+/// @param kind The kind passed with every span.
+/// @param parser The parser that delimits the token. It is only skipped.
+/// @return A parser function that returns an empty string.
+/// @note Only available for contiguous iterators: the span is a view into the
+///       source buffer and is valid until the buffer is released.
+template<typename H, typename K, typename F>
+auto token(H& handler, K kind, F&& parser) {
+    return make_parser([=, handler = &handler, parser = detail::hold(parser)]<CharIterator I, CharSentinel<I> S, typename M = parse_mode>(I& str_iter, S end, M = {})
+        -> detail::mode_result_t<M, std::string>
+        requires std::contiguous_iterator<I> {
+        auto first = str_iter;
+        auto r = try_skip(parser, str_iter, end);
+        if (!r) {
+            return r.error();
+        }
+        handler->on_token(kind, std::string_view(std::to_address(first), static_cast<std::size_t>(str_iter - first)));
+        if constexpr (M::skip) {
+            return {};
+        } else {
+            return std::string{};
+        }
+    }, no_skip{}, first_of(parser));
+}
+
+/// @brief Reports the number parsed by the parser as `handler.on_value(value)`.
+/// @tparam H The type of the handler.
+/// @tparam F The type of the parser function.
+/// @param handler The handler, which must outlive the parser.
+/// @param parser The numeric parser, e.g. `integer<long>()`.
+/// @return A parser function that returns an empty string.
+template<typename H, typename F>
+auto value(H& handler, F&& parser) {
+    return make_parser([=, handler = &handler, parser = detail::hold(parser)]<CharIterator I, CharSentinel<I> S, typename M = parse_mode>(I& str_iter, S end, M = {})
+        -> detail::mode_result_t<M, std::string> {
+        auto r = try_parse(parser, str_iter, end);
+        if (!r) {
+            return r.error();
+        }
+        handler->on_value(std::move(*r));
+        if constexpr (M::skip) {
+            return {};
+        } else {
+            return std::string{};
+        }
+    }, no_skip{}, first_of(parser));
+}
+
+/// @brief Reports every real number as `handler.on_value(double)`.
+/// @tparam H The type of the handler.
+/// @param handler The handler, which must outlive the parser.
+/// @return A parser function that returns an empty string.
+template<typename H>
+auto value(H& handler) {
+    return value(handler, real<double>());
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,219 @@
+#pragma once
+
+#include "simparse.hpp"
+
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+#include <unistd.h>
+
+namespace simparse {
+
+class stream_source;
+
+/// @brief The buffering limits of a stream_source.
+struct stream_options {
+    /// @brief The size of a chunk in bytes, rounded up to a power of two.
+    std::size_t chunk_size = std::size_t{1} << 16;
+    /// @brief The maximum number of bytes held, at least two chunks.
+    std::size_t window = std::size_t{1} << 22;
+};
+
+/// @brief The end of a stream_source: reached once the underlying input is exhausted.
+struct stream_sentinel {};
+
+/// @brief A forward iterator over a stream_source.
+/// @note Dereferencing reads more input on demand. Dereferencing a position that
+///       the source has already released throws std::out_of_range (aborts
+///       without exceptions, see SIMPARSE_EXCEPTIONS).
+class stream_iterator {
+public:
+    using value_type = char;
+    using difference_type = std::ptrdiff_t;
+    using reference = const char&;
+    using pointer = const char*;
+    using iterator_category = std::forward_iterator_tag;
+
+    stream_iterator() = default;
+    stream_iterator(stream_source* source, std::uint64_t pos) : source_(source), pos_(pos) {}
+
+    inline const char& operator*() const;
+
+    stream_iterator& operator++() {
+        ++pos_;
+        return *this;
+    }
+
+    stream_iterator operator++(int) {
+        auto copy = *this;
+        ++pos_;
+        return copy;
+    }
+
+    friend bool operator==(const stream_iterator& a, const stream_iterator& b) {
+        return a.pos_ == b.pos_;
+    }
+
+    inline friend bool operator==(const stream_iterator& it, stream_sentinel);
+
+    /// @brief The offset of the iterator from the beginning of the stream.
+    std::uint64_t position() const noexcept { return pos_; }
+
+    /// @brief Tells the source that no parser will rewind before this position.
+    inline void commit() const;
+
+private:
+    stream_source* source_ = nullptr;
+    std::uint64_t pos_ = 0;
+};
+
+/// @brief An input source reading a file descriptor or std::istream into a ring of
+///        fixed-size chunks.
+/// @details At most `window` bytes are held at any time. Chunks before the last
+///          commit point are released first; when the window is full the oldest
+///          chunk is dropped even without a commit, which bounds how far a parser
+///          may backtrack.
+class stream_source {
+public:
+    /// @brief Reads from the file descriptor `fd`, which stays owned by the caller.
+    explicit stream_source(int fd, stream_options opts = {})
+        : stream_source([fd](char* buf, std::size_t n) -> std::size_t {
+            while (true) {
+                auto r = ::read(fd, buf, n);
+                if (r >= 0) {
+                    return static_cast<std::size_t>(r);
+                }
+                if (errno != EINTR) {
+                    detail::raise<std::system_error>(errno, std::generic_category(), "read");
+                }
+            }
+        }, opts) {}
+
+    /// @brief Reads from the stream `in`, which must outlive the source.
+    explicit stream_source(std::istream& in, stream_options opts = {})
+        : stream_source([&in](char* buf, std::size_t n) -> std::size_t {
+            in.read(buf, static_cast<std::streamsize>(n));
+            return static_cast<std::size_t>(in.gcount());
+        }, opts) {}
+
+    /// @brief Reads through `read`, which fills up to `n` bytes and returns 0 at the end.
+    stream_source(std::function<std::size_t(char*, std::size_t)> read, stream_options opts)
+        : read_(std::move(read)),
+          shift_(std::countr_zero(std::bit_ceil(std::max<std::size_t>(opts.chunk_size, 1)))),
+          capacity_(std::max<std::size_t>(2, opts.window >> shift_)) {}
+
+    stream_source(const stream_source&) = delete;
+    stream_source& operator=(const stream_source&) = delete;
+
+    stream_iterator begin() { return {this, 0}; }
+    stream_sentinel end() const { return {}; }
+
+    /// @brief The character at `pos`, reading more input if needed.
+    const char& at(std::uint64_t pos) {
+        auto idx = pos >> shift_;
+        if (idx < base_) {
+            detail::raise<std::out_of_range>("simparse::stream_source: position already released");
+        }
+        while (pos >= loaded_) {
+            if (!load()) {
+                detail::raise<std::out_of_range>("simparse::stream_source: read past the end");
+            }
+        }
+        return chunks_[idx - base_][pos & mask()];
+    }
+
+    /// @brief Checks whether `pos` is at or past the end of the input.
+    bool exhausted(std::uint64_t pos) {
+        while (pos >= loaded_ && !eof_) {
+            load();
+        }
+        return pos >= loaded_;
+    }
+
+    /// @brief Releases the chunks that lie entirely before `pos`.
+    void commit(std::uint64_t pos) {
+        while (!chunks_.empty() && ((base_ + 1) << shift_) <= pos && (base_ + 1) << shift_ <= loaded_) {
+            release();
+        }
+    }
+
+    /// @brief The number of bytes currently held.
+    std::size_t buffered() const noexcept { return chunks_.size() << shift_; }
+
+    /// @brief The size of a chunk in bytes.
+    std::size_t chunk_size() const noexcept { return std::size_t{1} << shift_; }
+
+private:
+    std::size_t mask() const noexcept { return (std::size_t{1} << shift_) - 1; }
+
+    void release() {
+        spare_.push_back(std::move(chunks_.front()));
+        chunks_.pop_front();
+        ++base_;
+    }
+
+    bool load() {
+        if (eof_) {
+            return false;
+        }
+        if (chunks_.size() == capacity_) {
+            release();
+        }
+        std::unique_ptr<char[]> chunk;
+        if (spare_.empty()) {
+            chunk = std::make_unique_for_overwrite<char[]>(chunk_size());
+        } else {
+            chunk = std::move(spare_.back());
+            spare_.pop_back();
+        }
+        // Fill the chunk completely so that positions map to chunks by a shift.
+        std::size_t filled = 0;
+        while (filled < chunk_size()) {
+            auto n = read_(chunk.get() + filled, chunk_size() - filled);
+            if (n == 0) {
+                eof_ = true;
+                break;
+            }
+            filled += n;
+        }
+        if (filled == 0) {
+            spare_.push_back(std::move(chunk));
+            return false;
+        }
+        chunks_.push_back(std::move(chunk));
+        loaded_ += filled;
+        return true;
+    }
+
+    std::function<std::size_t(char*, std::size_t)> read_;
+    int shift_;
+    std::size_t capacity_;
+    std::deque<std::unique_ptr<char[]>> chunks_;
+    std::vector<std::unique_ptr<char[]>> spare_;
+    std::uint64_t base_ = 0;
+    std::uint64_t loaded_ = 0;
+    bool eof_ = false;
+};
+
+inline const char& stream_iterator::operator*() const {
+    return source_->at(pos_);
+}
+
+inline bool operator==(const stream_iterator& it, stream_sentinel) {
+    return it.source_->exhausted(it.pos_);
+}
+
+inline void stream_iterator::commit() const {
+    source_->commit(pos_);
+}
+
+}
\ No newline at end of file
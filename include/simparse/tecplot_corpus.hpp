@@ -0,0 +1,203 @@
+#pragma once
+
+#include "simparse.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace simparse {
+
+/// @brief The shape and formatting of a synthetic Tecplot ASCII file.
+struct tecplot_options {
+    /// @brief How the values of a zone are laid out.
+    enum class packing {
+        point, ///< One node per line group: all variables of a node, then the next node.
+        block, ///< All nodes of a variable, then the next variable.
+    };
+
+    /// @brief The number of variables. The first three are named X, Y and Z.
+    std::size_t variables = 4;
+    /// @brief The number of zones, all of the same size.
+    std::size_t zones = 1;
+    /// @brief The I, J and K sizes of every zone.
+    std::size_t i = 64;
+    std::size_t j = 1;
+    std::size_t k = 1;
+    packing data_packing = packing::point;
+    /// @brief The notation of the values, as for `std::to_chars`.
+    std::chars_format format = std::chars_format::scientific;
+    /// @brief The precision of the values, as for `std::to_chars`.
+    int precision = 6;
+    /// @brief The maximum number of values on a line; 0 for no limit. In POINT
+    ///        packing every node also starts a new line.
+    std::size_t values_per_line = 5;
+    /// @brief The seed of the values. The output is a function of the options only.
+    std::uint64_t seed = 1;
+};
+
+namespace detail {
+
+/// @brief The splitmix64 finalizer, a stateless hash from a counter to 64 random bits.
+constexpr std::uint64_t splitmix64(std::uint64_t x) {
+    x += 0x9e3779b97f4a7c15;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+    return x ^ (x >> 31);
+}
+
+/// @brief Buffers the generated text and hands it to the stream in large blocks.
+class corpus_writer {
+public:
+    explicit corpus_writer(std::ostream& out) : out_(out) {
+        buffer_.reserve(block_size + 256);
+    }
+
+    ~corpus_writer() { flush(); }
+
+    void put(std::string_view text) {
+        buffer_.append(text);
+        if (buffer_.size() >= block_size) {
+            flush();
+        }
+    }
+
+    void put(char c) {
+        buffer_.push_back(c);
+    }
+
+    /// @note Raises std::length_error if the value cannot be formatted, rather
+    ///       than writing a corrupt corpus.
+    void put(double value, std::chars_format format, int precision) {
+        // Room for any double: a sign, 309 integer digits, the point, the
+        // requested digits and an exponent.
+        auto size = static_cast<std::size_t>(std::max(precision, 0)) + 330;
+        if (digits_.size() < size) {
+            digits_.resize(size);
+        }
+        auto [end, ec] = std::to_chars(digits_.data(), digits_.data() + digits_.size(), value, format, precision);
+        if (ec != std::errc{}) {
+            raise<std::length_error>("simparse: corpus value does not fit its buffer");
+        }
+        put(std::string_view(digits_.data(), static_cast<std::size_t>(end - digits_.data())));
+    }
+
+    void flush() {
+        out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        buffer_.clear();
+    }
+
+private:
+    static constexpr std::size_t block_size = std::size_t{1} << 16;
+
+    std::ostream& out_;
+    std::string buffer_;
+    std::string digits_;
+};
+
+/// @brief The value of variable `var` at node (i, j, k) of zone `zone`.
+/// @note Coordinates are a uniform grid on [0, 1] shifted by the zone index; the other variables are
+///       random with magnitudes between 1e-3 and 1e3, so that every notation
+///       exercises signs, exponents and long mantissas.
+inline double corpus_value(const tecplot_options& options, std::size_t zone, std::size_t var,
+                           std::size_t i, std::size_t j, std::size_t k) {
+    std::size_t sizes[] = {options.i, options.j, options.k};
+    std::size_t index[] = {i, j, k};
+    if (var < 3) {
+        auto n = sizes[var];
+        return n > 1 ? static_cast<double>(index[var]) / static_cast<double>(n - 1) + static_cast<double>(zone) : 0.0;
+    }
+    auto node = (k * options.j + j) * options.i + i;
+    auto bits = splitmix64(options.seed ^ splitmix64((zone * options.variables + var) ^ splitmix64(node)));
+    auto mantissa = static_cast<double>(bits >> 11) * 0x1p-53 * 2.0 - 1.0;
+    constexpr double scales[] = {1e-3, 1e-2, 1e-1, 1.0, 1e1, 1e2, 1e3};
+    return mantissa * scales[(bits & 0xff) % 7];
+}
+
+}
+
+/// @brief Writes a deterministic Tecplot ASCII file with the given shape.
+/// @param out The destination stream.
+/// @param options The number of variables and zones, the zone sizes, the data packing,
+///                the number format and the line length.
+/// @note The same options always produce the same bytes, and POINT and BLOCK
+///       packing write the same values. The text is generated in 64 KiB blocks,
+///       so files of several gigabytes can be written straight to disk.
+inline void write_tecplot(std::ostream& out, const tecplot_options& options) {
+    detail::corpus_writer w(out);
+    w.put("TITLE = \"simparse synthetic corpus\"\nVARIABLES =");
+    for (std::size_t v = 0; v < options.variables; ++v) {
+        w.put(v == 0 ? " \"" : ", \"");
+        if (v < 3) {
+            w.put(static_cast<char>('X' + v));
+        } else {
+            w.put('V');
+            w.put(std::to_string(v + 1));
+        }
+        w.put('"');
+    }
+    w.put('\n');
+
+    bool point = options.data_packing == tecplot_options::packing::point;
+    auto nodes = options.i * options.j * options.k;
+    for (std::size_t z = 0; z < options.zones; ++z) {
+        w.put("ZONE T=\"zone " + std::to_string(z + 1) + "\", I=" + std::to_string(options.i)
+              + ", J=" + std::to_string(options.j) + ", K=" + std::to_string(options.k)
+              + (point ? ", DATAPACKING=POINT\n" : ", DATAPACKING=BLOCK\n"));
+
+        std::size_t on_line = 0;
+        auto value = [&](std::size_t var, std::size_t node) {
+            if (on_line > 0) {
+                w.put(options.values_per_line != 0 && on_line == options.values_per_line ? '\n' : ' ');
+                if (on_line == options.values_per_line) {
+                    on_line = 0;
+                }
+            }
+            auto i = node % options.i;
+            auto j = node / options.i % options.j;
+            auto k = node / options.i / options.j;
+            w.put(detail::corpus_value(options, z, var, i, j, k), options.format, options.precision);
+            ++on_line;
+        };
+        auto end_line = [&] {
+            if (on_line > 0) {
+                w.put('\n');
+                on_line = 0;
+            }
+        };
+
+        if (point) {
+            for (std::size_t n = 0; n < nodes; ++n) {
+                for (std::size_t v = 0; v < options.variables; ++v) {
+                    value(v, n);
+                }
+                end_line();
+            }
+        } else {
+            for (std::size_t v = 0; v < options.variables; ++v) {
+                for (std::size_t n = 0; n < nodes; ++n) {
+                    value(v, n);
+                }
+                end_line();
+            }
+        }
+    }
+}
+
+/// @brief Generates a deterministic Tecplot ASCII file in memory.
+/// @param options The shape of the file, see `write_tecplot`.
+/// @return The text of the file.
+inline std::string make_tecplot(const tecplot_options& options) {
+    std::ostringstream out;
+    write_tecplot(out, options);
+    return std::move(out).str();
+}
+
+}
\ No newline at end of file
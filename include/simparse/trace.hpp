@@ -0,0 +1,243 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/// @brief Enables the trace spans. Off by default: a span then records nothing
+///        and `write_chrome_trace` writes an empty trace. The core header only
+///        includes this file, and compiles its spans in, when it is set.
+#if !defined(SIMPARSE_TRACE)
+#define SIMPARSE_TRACE 0
+#endif
+
+namespace simparse {
+
+/// @brief One completed span of the timeline.
+struct trace_event {
+    /// @brief The name of the span; a string with static storage duration.
+    const char* name;
+    /// @brief The start and end in trace clock ticks.
+    std::uint64_t begin;
+    std::uint64_t end;
+    /// @brief A value shown with the span, e.g. a chunk index.
+    std::uint64_t arg;
+};
+
+// The two configurations live in different inline namespaces. This does not make them
+// mixable: rules, `integer_list`, `values_into` and `parallel_many` expand
+// SIMPARSE_TRACE_SPAN in their bodies, so every translation unit of a program
+// must be built with the same SIMPARSE_TRACE.
+#if SIMPARSE_TRACE
+namespace detail {
+
+/// @brief The clock of the spans: the time-stamp counter where available.
+inline std::uint64_t trace_clock() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+inline std::uint64_t steady_ns() noexcept {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/// @brief The spans of one thread. Only the owning thread writes; the oldest
+///        events are overwritten once the ring is full.
+struct trace_ring {
+    static constexpr std::size_t capacity = std::size_t{1} << 16;
+
+    explicit trace_ring(std::uint32_t tid) : events(capacity), tid(tid) {}
+
+    void push(const trace_event& event) noexcept {
+        auto n = head.load(std::memory_order_relaxed);
+        events[n & (capacity - 1)] = event;
+        head.store(n + 1, std::memory_order_release);
+    }
+
+    std::vector<trace_event> events;
+    std::atomic<std::uint64_t> head{0};
+    std::uint32_t tid;
+};
+
+/// @brief The rings of every thread that recorded a span, kept after the thread exits.
+struct trace_state {
+    static trace_state& instance() {
+        static trace_state state;
+        return state;
+    }
+
+    std::shared_ptr<trace_ring> make_ring() {
+        std::lock_guard lock(mutex);
+        auto ring = std::make_shared<trace_ring>(static_cast<std::uint32_t>(rings.size() + 1));
+        rings.push_back(ring);
+        return ring;
+    }
+
+    std::atomic<bool> enabled{false};
+    // A clock reading taken when tracing starts, to convert ticks to microseconds.
+    std::uint64_t origin_ticks = 0;
+    std::uint64_t origin_ns = 0;
+    std::mutex mutex;
+    std::vector<std::shared_ptr<trace_ring>> rings;
+};
+
+inline trace_ring& this_thread_ring() {
+    thread_local std::shared_ptr<trace_ring> ring = trace_state::instance().make_ring();
+    return *ring;
+}
+
+}
+
+inline namespace trace_enabled {
+
+/// @brief Whether spans are being recorded.
+inline bool tracing() noexcept {
+    return detail::trace_state::instance().enabled.load(std::memory_order_relaxed);
+}
+
+/// @brief Starts recording spans on every thread.
+inline void start_tracing() {
+    auto& state = detail::trace_state::instance();
+    if (!state.enabled.load(std::memory_order_relaxed)) {
+        std::lock_guard lock(state.mutex);
+        state.origin_ticks = detail::trace_clock();
+        state.origin_ns = detail::steady_ns();
+        state.enabled.store(true, std::memory_order_relaxed);
+    }
+}
+
+/// @brief Stops recording spans. The recorded spans are kept until `clear_trace`.
+inline void stop_tracing() {
+    detail::trace_state::instance().enabled.store(false, std::memory_order_relaxed);
+}
+
+/// @brief Drops the recorded spans. Call it while no thread is recording.
+inline void clear_trace() {
+    auto& state = detail::trace_state::instance();
+    std::lock_guard lock(state.mutex);
+    for (auto& ring : state.rings) {
+        ring->head.store(0, std::memory_order_relaxed);
+    }
+}
+
+/// @brief Records the lifetime of a scope as a span of the current thread.
+/// @note While tracing is stopped a span costs one relaxed load. While it runs,
+///       a span reads the clock twice and writes one event to a thread-local
+///       ring, without locks; only the first span of a thread registers its ring.
+class trace_span {
+public:
+    /// @param name The name of the span, a string literal or another string that
+    ///             outlives the trace. No span is recorded for a null name.
+    /// @param arg A value shown with the span.
+    explicit trace_span(const char* name, std::uint64_t arg = 0) noexcept
+        : name_(name && tracing() ? name : nullptr), arg_(arg), begin_(name_ ? detail::trace_clock() : 0) {}
+
+    trace_span(const trace_span&) = delete;
+    trace_span& operator=(const trace_span&) = delete;
+
+    ~trace_span() {
+        if (name_) {
+            detail::this_thread_ring().push({name_, begin_, detail::trace_clock(), arg_});
+        }
+    }
+
+private:
+    const char* name_;
+    std::uint64_t arg_;
+    std::uint64_t begin_;
+};
+
+/// @brief Writes the recorded spans as a Chrome `trace_event` JSON document.
+/// @details The output loads in Perfetto (ui.perfetto.dev) and chrome://tracing:
+///          every span is a complete event ("ph": "X") on the track of the thread
+///          that recorded it, with timestamps in microseconds since `start_tracing`.
+/// @note Call it once the traced threads are done; spans recorded concurrently
+///       may be missing or torn.
+inline void write_chrome_trace(std::ostream& out) {
+    auto& state = detail::trace_state::instance();
+    std::lock_guard lock(state.mutex);
+
+    // Ticks per microsecond, from the clock readings at the start and now.
+    auto ticks = detail::trace_clock() - state.origin_ticks;
+    auto ns = detail::steady_ns() - state.origin_ns;
+    double per_us = ns > 0 && ticks > 0 ? static_cast<double>(ticks) / (static_cast<double>(ns) / 1000.0) : 1000.0;
+    auto micros = [&](std::uint64_t t) {
+        return static_cast<double>(static_cast<std::int64_t>(t - state.origin_ticks)) / per_us;
+    };
+
+    auto flags = out.flags();
+    auto precision = out.precision();
+    out << std::fixed << std::setprecision(3) << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    for (const auto& ring : state.rings) {
+        auto head = ring->head.load(std::memory_order_acquire);
+        auto begin = head > detail::trace_ring::capacity ? head - detail::trace_ring::capacity : 0;
+        if (begin == head) {
+            continue;
+        }
+        out << (first ? "" : ",") << "\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << ring->tid
+            << ",\"args\":{\"name\":\"simparse " << ring->tid << "\"}}";
+        first = false;
+        for (auto n = begin; n < head; ++n) {
+            const auto& e = ring->events[n & (detail::trace_ring::capacity - 1)];
+            out << ",\n{\"ph\":\"X\",\"name\":\"";
+            for (const char* c = e.name; *c; ++c) {
+                if (*c == '"' || *c == '\\') {
+                    out << '\\';
+                }
+                out << *c;
+            }
+            out << "\",\"pid\":1,\"tid\":" << ring->tid << ",\"ts\":" << micros(e.begin)
+                << ",\"dur\":" << static_cast<double>(e.end - e.begin) / per_us
+                << ",\"args\":{\"arg\":" << e.arg << "}}";
+        }
+    }
+    out << "\n]}\n";
+    out.flags(flags);
+    out.precision(precision);
+}
+
+}
+#else
+inline namespace trace_disabled {
+
+inline bool tracing() noexcept {
+    return false;
+}
+
+inline void start_tracing() {}
+
+inline void stop_tracing() {}
+
+inline void clear_trace() {}
+
+class trace_span {
+public:
+    constexpr explicit trace_span(const char*, std::uint64_t = 0) noexcept {}
+
+    trace_span(const trace_span&) = delete;
+    trace_span& operator=(const trace_span&) = delete;
+};
+
+inline void write_chrome_trace(std::ostream& out) {
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n]}\n";
+}
+
+}
+#endif
+
+}
\ No newline at end of file
@@ -0,0 +1,438 @@
+#pragma once
+
+#include "simparse.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace simparse::vm {
+
+/// @brief A grammar expression built at runtime and compiled to a program.
+/// @note Expressions are immutable and share their subexpressions.
+class expr {
+public:
+    enum class kind : std::uint8_t { cls, literal, sequence, choice, many, optional, capture, cut };
+
+    struct node {
+        kind tag;
+        char_class chars;
+        std::string text;
+        std::vector<expr> children;
+    };
+
+    explicit expr(node n) : node_(std::make_shared<const node>(std::move(n))) {}
+
+    const node& operator*() const noexcept { return *node_; }
+    const node* operator->() const noexcept { return node_.get(); }
+
+private:
+    std::shared_ptr<const node> node_;
+};
+
+/// @brief Matches one character of the class.
+inline expr cls(const char_class& chars) {
+    return expr({expr::kind::cls, chars, {}, {}});
+}
+
+/// @brief Matches the literal string.
+inline expr lit(std::string text) {
+    return expr({expr::kind::literal, {}, std::move(text), {}});
+}
+
+/// @brief Matches zero or more repetitions of the expression.
+inline expr many(expr e) {
+    return expr({expr::kind::many, {}, {}, {std::move(e)}});
+}
+
+/// @brief Matches the expression or nothing.
+inline expr optional(expr e) {
+    return expr({expr::kind::optional, {}, {}, {std::move(e)}});
+}
+
+/// @brief Adds the input matched by the expression to the result.
+/// @note Captures must not nest. Without any capture the result is the whole match.
+inline expr capture(expr e) {
+    return expr({expr::kind::capture, {}, {}, {std::move(e)}});
+}
+
+/// @brief Discards the pending alternatives: a failure in the rest of the enclosing
+///        alternative is fatal, like after `simparse::commit`.
+inline expr cut() {
+    return expr({expr::kind::cut, {}, {}, {}});
+}
+
+/// @brief Matches `a` followed by `b`.
+inline expr operator+(expr a, expr b) {
+    return expr({expr::kind::sequence, {}, {}, {std::move(a), std::move(b)}});
+}
+
+/// @brief Matches `a`, or `b` from the same position if `a` fails (ordered choice).
+inline expr operator|(expr a, expr b) {
+    return expr({expr::kind::choice, {}, {}, {std::move(a), std::move(b)}});
+}
+
+/// @brief The instructions of the parsing machine.
+enum class opcode : std::uint8_t {
+    cls,            ///< Match one character of classes[arg].
+    literal,        ///< Match literals[arg].
+    span,           ///< Skip the run of characters of classes[arg].
+    choice,         ///< Push a backtrack entry resuming at arg.
+    commit,         ///< Pop the backtrack entry and jump to arg.
+    partial_commit, ///< Update the backtrack entry to the current position and jump to arg.
+    open,           ///< Start a capture.
+    close,          ///< End a capture.
+    cut,            ///< Make failures fatal until the enclosing alternative ends.
+    fail,           ///< Fail, so that the backtrack entry below is resumed.
+    end,            ///< Succeed.
+};
+
+struct instruction {
+    opcode op;
+    std::uint32_t arg;
+};
+
+/// @brief A compiled grammar.
+/// @note Choices backtrack to their starting position, like `back(a) | b`.
+class program {
+public:
+    /// @brief Runs the program on [str_iter, last), or up to the terminating NUL
+    ///        when `last` is a `null_sentinel`.
+    /// @return The concatenated captures, or the whole match if the grammar has no capture.
+    /// @note On failure the iterator is unchanged, unless the failure is fatal,
+    ///       in which case it points where the match failed. A terminated input is
+    ///       checked while matching, so it is never measured up front.
+    template<CharSentinel<const char*> S>
+        requires std::same_as<S, const char*> || std::same_as<S, null_sentinel>
+    parse_result<std::string> run(const char*& str_iter, S last) const {
+        struct backtrack {
+            std::uint32_t pc;
+            const char* pos;
+            std::size_t captures;
+            std::size_t barrier;
+        };
+        // The machine calls no other parser, so the scratch stacks can be reused.
+        thread_local std::vector<backtrack> stack;
+        thread_local std::vector<std::pair<const char*, const char*>> captures;
+        stack.clear();
+        captures.clear();
+
+        const char* p = str_iter;
+        const char* capture_start = p;
+        // One more than the stack depth at the last cut, or 0 without a cut: the entries
+        // below it cannot be resumed. Every entry saves the barrier of its alternative,
+        // and popping it restores that barrier, so a cut ends with its alternative.
+        std::size_t barrier = 0;
+        std::uint32_t pc = 0;
+        while (true) {
+            const auto& ins = code_[pc];
+            switch (ins.op) {
+            case opcode::cls:
+                if (p != last && classes_[ins.arg].cls.contains(*p)) {
+                    ++p;
+                    ++pc;
+                    continue;
+                }
+                break;
+            case opcode::literal: {
+                const auto& text = literals_[ins.arg];
+                if (match_literal(p, last, text)) {
+                    p += text.size();
+                    ++pc;
+                    continue;
+                }
+                break;
+            }
+            case opcode::span:
+                classes_[ins.arg].scan(p, last);
+                ++pc;
+                continue;
+            case opcode::choice:
+                stack.push_back({ins.arg, p, captures.size(), barrier});
+                ++pc;
+                continue;
+            case opcode::commit:
+                barrier = stack.back().barrier;
+                stack.pop_back();
+                pc = ins.arg;
+                continue;
+            case opcode::partial_commit: {
+                auto& top = stack.back();
+                barrier = top.barrier;
+                if (top.pos == p) {
+                    // The loop body matched nothing: leave the loop.
+                    pc = top.pc;
+                    stack.pop_back();
+                } else {
+                    top.pos = p;
+                    top.captures = captures.size();
+                    pc = ins.arg;
+                }
+                continue;
+            }
+            case opcode::open:
+                capture_start = p;
+                ++pc;
+                continue;
+            case opcode::close:
+                captures.emplace_back(capture_start, p);
+                ++pc;
+                continue;
+            case opcode::cut:
+                barrier = stack.size() + 1;
+                ++pc;
+                continue;
+            case opcode::fail:
+                break;
+            case opcode::end: {
+                std::string result;
+                if (has_captures_) {
+                    for (auto [first, stop] : captures) {
+                        result.append(first, stop);
+                    }
+                } else {
+                    result.assign(str_iter, p);
+                }
+                str_iter = p;
+                return result;
+            }
+            }
+
+            // The instruction failed.
+            if (stack.size() < barrier) {
+                str_iter = p;
+                return parse_error{"Committed grammar failed.", true};
+            }
+            if (stack.empty()) {
+                return parse_error{"Grammar not matched."};
+            }
+            auto top = stack.back();
+            stack.pop_back();
+            p = top.pos;
+            captures.resize(top.captures);
+            barrier = top.barrier;
+            pc = top.pc;
+        }
+    }
+
+    /// @brief The characters a match can start with.
+    const first_set& first() const noexcept { return first_; }
+
+    /// @brief The bytecode of the program.
+    const std::vector<instruction>& code() const noexcept { return code_; }
+
+private:
+    friend parse_result<program> try_compile(const expr& e);
+
+    template<typename S>
+    static bool match_literal(const char* p, S last, const std::string& text) {
+        if constexpr (std::same_as<S, null_sentinel>) {
+            // Stops at the first mismatch, so the terminator is never passed.
+            for (char c : text) {
+                if (*p == '\0' || *p != c) {
+                    return false;
+                }
+                ++p;
+            }
+            return true;
+        } else {
+            return static_cast<std::size_t>(last - p) >= text.size()
+                && std::memcmp(p, text.data(), text.size()) == 0;
+        }
+    }
+
+    std::vector<instruction> code_;
+    std::vector<class_parser> classes_;
+    std::vector<std::string> literals_;
+    first_set first_{char_class{}, true};
+    bool has_captures_ = false;
+};
+
+namespace detail {
+
+class compiler {
+public:
+    compiler(std::vector<instruction>& code, std::vector<class_parser>& classes,
+             std::vector<std::string>& literals, bool& has_captures)
+        : code_(code), classes_(classes), literals_(literals), has_captures_(has_captures) {}
+
+    /// @brief Emits the code of `e` and returns its first set.
+    first_set emit(const expr& e, bool in_capture = false) {
+        switch (e->tag) {
+        case expr::kind::cls:
+            push(opcode::cls, add_class(e->chars));
+            return {e->chars, false};
+        case expr::kind::literal:
+            if (e->text.empty()) {
+                return {char_class{}, true};
+            }
+            push(opcode::literal, static_cast<std::uint32_t>(literals_.size()));
+            literals_.push_back(e->text);
+            return {char_class::of(e->text[0]), false};
+        case expr::kind::sequence: {
+            auto a = emit(e->children[0], in_capture);
+            auto b = emit(e->children[1], in_capture);
+            return simparse::detail::first_of_sequence(a, b);
+        }
+        case expr::kind::choice: {
+            // choice L1; a; commit L2; L1: b; L2:
+            auto choice = push(opcode::choice, 0);
+            auto a = emit(e->children[0], in_capture);
+            auto commit = push(opcode::commit, 0);
+            code_[choice].arg = here();
+            if (!has_cut(e->children[1])) {
+                auto b = emit(e->children[1], in_capture);
+                code_[commit].arg = here();
+                return simparse::detail::first_of_choice(a, b);
+            }
+            // The last alternative gets an entry of its own, so that its cut ends with it:
+            // L1: choice L3; b; commit L2; L3: fail; L2:
+            auto last = push(opcode::choice, 0);
+            auto b = emit(e->children[1], in_capture);
+            auto last_commit = push(opcode::commit, 0);
+            code_[last].arg = push(opcode::fail, 0);
+            code_[commit].arg = code_[last_commit].arg = here();
+            return simparse::detail::first_of_choice(a, b);
+        }
+        case expr::kind::many: {
+            const auto& body = e->children[0];
+            if (body->tag == expr::kind::cls) {
+                push(opcode::span, add_class(body->chars));
+                return {body->chars, true};
+            }
+            // choice L1; L0: body; partial_commit L0; L1:
+            auto choice = push(opcode::choice, 0);
+            auto loop = here();
+            auto a = emit(body, in_capture);
+            push(opcode::partial_commit, loop);
+            code_[choice].arg = here();
+            return {a.chars, true};
+        }
+        case expr::kind::optional: {
+            auto choice = push(opcode::choice, 0);
+            auto a = emit(e->children[0], in_capture);
+            push(opcode::commit, here() + 1);
+            code_[choice].arg = here();
+            return {a.chars, true};
+        }
+        case expr::kind::capture: {
+            if (in_capture) {
+                error_ = "simparse::vm: captures must not nest";
+                return first_set::unknown();
+            }
+            has_captures_ = true;
+            push(opcode::open, 0);
+            auto a = emit(e->children[0], true);
+            push(opcode::close, 0);
+            return a;
+        }
+        case expr::kind::cut:
+            push(opcode::cut, 0);
+            return {char_class{}, true};
+        }
+        return first_set::unknown();
+    }
+
+    /// @brief The error of an invalid expression, or null.
+    const char* error() const noexcept {
+        return error_;
+    }
+
+private:
+    static bool has_cut(const expr& e) {
+        if (e->tag == expr::kind::cut) {
+            return true;
+        }
+        for (const auto& child : e->children) {
+            if (has_cut(child)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::uint32_t here() const {
+        return static_cast<std::uint32_t>(code_.size());
+    }
+
+    std::uint32_t push(opcode op, std::uint32_t arg) {
+        code_.push_back({op, arg});
+        return here() - 1;
+    }
+
+    std::uint32_t add_class(const char_class& chars) {
+        for (std::size_t i = 0; i < classes_.size(); ++i) {
+            if (classes_[i].cls == chars) {
+                return static_cast<std::uint32_t>(i);
+            }
+        }
+        classes_.emplace_back(chars);
+        return static_cast<std::uint32_t>(classes_.size() - 1);
+    }
+
+    std::vector<instruction>& code_;
+    std::vector<class_parser>& classes_;
+    std::vector<std::string>& literals_;
+    bool& has_captures_;
+    const char* error_ = nullptr;
+};
+
+}
+
+/// @brief Compiles the expression into a program.
+/// @return The program, or the error of an invalid expression (nested captures).
+inline parse_result<program> try_compile(const expr& e) {
+    program prog;
+    detail::compiler c(prog.code_, prog.classes_, prog.literals_, prog.has_captures_);
+    prog.first_ = c.emit(e);
+    if (c.error()) {
+        return parse_error{c.error()};
+    }
+    prog.code_.push_back({opcode::end, 0});
+    return prog;
+}
+
+/// @brief Compiles the expression into a program.
+/// @note Throws std::invalid_argument for nested captures.
+inline program compile(const expr& e) {
+    auto result = try_compile(e);
+    if (!result) {
+        simparse::detail::raise<std::invalid_argument>(result.error().message);
+    }
+    return std::move(*result);
+}
+
+/// @brief Wraps a compiled program into a parser object.
+/// @param prog The program to run.
+/// @return A parser function that returns the concatenated captures.
+/// @note Only available for contiguous iterators, with a sized sentinel (e.g. an
+///       end pointer), a `padded_sentinel` or a `null_sentinel`. The program is
+///       shared between copies of the parser.
+inline auto parser(program prog) {
+    auto shared = std::make_shared<const program>(std::move(prog));
+    return make_parser([=]<CharIterator I, CharSentinel<I> S>(I& str_iter, S end) -> parse_result<std::string>
+        requires std::contiguous_iterator<I>
+            && (std::same_as<S, null_sentinel> || std::sized_sentinel_for<S, I> || simparse::detail::padding_v<S> > 0) {
+        const char* first = std::to_address(str_iter);
+        const char* p = first;
+        auto result = [&] {
+            if constexpr (std::same_as<S, null_sentinel>) {
+                return shared->run(p, end);
+            } else if constexpr (std::sized_sentinel_for<S, I>) {
+                return shared->run(p, first + (end - str_iter));
+            } else {
+                // A padded_sentinel: the padding is not needed, only the end.
+                return shared->run(p, static_cast<const char*>(std::to_address(end.end)));
+            }
+        }();
+        str_iter += p - first;
+        return result;
+    }, no_skip{}, shared->first());
+}
+
+}
\ No newline at end of file
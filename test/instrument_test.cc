@@ -0,0 +1,53 @@
+#if !defined(SIMPARSE_INSTRUMENT)
+#define SIMPARSE_INSTRUMENT 1
+#endif
+#include "simparse/instrument.hpp"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+TEST(InstrumentTests, ProbeCounters) {
+    simparse::reset_probes();
+    auto long_keyword = simparse::probe("VARIABLES", simparse::string("VARIABLES"));
+    auto short_keyword = simparse::probe("VAR", simparse::string("VAR"));
+    auto keyword = simparse::probe("keyword", simparse::back(long_keyword) | short_keyword);
+    auto blanks = simparse::ignore(simparse::many(simparse::whitespace));
+
+    std::string str = "VAR VARIABLES VAR";
+    auto it = str.begin();
+    for (int i = 0; i < 3; ++i) {
+        keyword(it, str.end());
+        blanks(it, str.end());
+    }
+    EXPECT_EQ(it, str.end());
+
+    auto records = simparse::probe_records();
+    ASSERT_EQ(records.size(), 3u);
+    EXPECT_EQ(records[0].name, "keyword");
+    for (std::size_t i = 1; i < records.size(); ++i) {
+        EXPECT_GE(records[i - 1].cycles, records[i].cycles);
+    }
+    for (const auto& r : records) {
+        if (r.name == "keyword") {
+            EXPECT_EQ(r.calls, 3u);
+            EXPECT_EQ(r.consumed, 15u);
+        } else if (r.name == "VARIABLES") {
+            EXPECT_EQ(r.calls, 3u);
+            EXPECT_EQ(r.successes, 1u);
+            EXPECT_EQ(r.failures, 2u);
+            EXPECT_EQ(r.backtracked, 6u);
+        } else {
+            EXPECT_EQ(r.name, "VAR");
+            EXPECT_EQ(r.calls, 2u);
+            EXPECT_EQ(r.consumed, 6u);
+        }
+    }
+
+    std::ostringstream report;
+    simparse::write_probe_report(report);
+    EXPECT_EQ(report.str().rfind("probe", 0), 0u);
+    EXPECT_NE(report.str().find("\nkeyword "), std::string::npos);
+
+    simparse::reset_probes();
+    EXPECT_EQ(simparse::probe_records()[0].calls, 0u);
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#include "simparse/mapped_file.hpp"
+#include "simparse.hpp"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <system_error>
+
+namespace {
+
+std::string write_temp(const std::string& name, const std::string& content) {
+    auto path = testing::TempDir() + name;
+    std::ofstream(path, std::ios::binary) << content;
+    return path;
+}
+
+}
+
+TEST(MappedFileTests, ParseInPlace) {
+    auto path = write_temp("simparse_mapped.dat", "VARIABLES = \"X\" \"Y\"\n");
+    simparse::mapped_file file(path);
+    ASSERT_EQ(file.size(), 20u);
+
+    auto key = simparse::view(simparse::many(simparse::alphabet));
+    auto it = file.begin();
+    std::string_view result = key(it, file.end());
+    EXPECT_EQ(result, "VARIABLES");
+    EXPECT_EQ(result.data(), file.data());
+
+    simparse::mapped_file moved = std::move(file);
+    EXPECT_TRUE(file.empty());
+    EXPECT_EQ(moved.view().substr(10, 1), "=");
+    std::remove(path.c_str());
+}
+
+TEST(MappedFileTests, EmptyAndMissing) {
+    auto path = write_temp("simparse_empty.dat", "");
+    simparse::mapped_file file(path, simparse::mapped_file::advice::random);
+    EXPECT_TRUE(file.empty());
+    EXPECT_EQ(file.begin(), file.end());
+    std::remove(path.c_str());
+
+#if SIMPARSE_EXCEPTIONS
+    EXPECT_THROW(simparse::mapped_file(testing::TempDir() + "simparse_missing.dat"), std::system_error);
+#endif
+}
@@ -0,0 +1,103 @@
+#include "simparse.hpp"
+#include "simparse/mapped_file.hpp"
+#include "simparse/numeric.hpp"
+#include "simparse/vm.hpp"
+#include <gtest/gtest.h>
+#include <span>
+#include <string>
+#include <system_error>
+#include <tuple>
+#include <vector>
+
+// Built with -fno-exceptions: failures are only observed through parse_result.
+static_assert(!SIMPARSE_EXCEPTIONS);
+
+TEST(NoExceptionsTests, ExampleGrammar) {
+    std::string str = "VARIABLES= \"var1\", \"var2\" ,\"var3\"";
+    auto it = str.begin();
+    auto label = simparse::back(
+        simparse::string("VARIABLES")
+        + simparse::many(simparse::whitespace)
+        + simparse::string("=")
+        + simparse::many(simparse::whitespace)
+    );
+    auto item = simparse::back(
+        simparse::ignore(simparse::string("\""))
+        + simparse::many(simparse::alphanumeric)
+        + simparse::ignore(simparse::string("\""))
+        + simparse::ignore(
+            simparse::many(simparse::whitespace)
+            + simparse::many(simparse::string(","))
+            + simparse::many(simparse::whitespace)
+        )
+    );
+
+    EXPECT_EQ(label(it, str.end()), "VARIABLES= ");
+    std::vector<std::string> names;
+    while (auto r = simparse::try_parse(item, it, str.end())) {
+        names.push_back(std::move(*r));
+    }
+    EXPECT_EQ(names, (std::vector<std::string>{"var1", "var2", "var3"}));
+    EXPECT_EQ(it, str.end());
+    EXPECT_FALSE(simparse::try_parse(label, it, str.end()));
+}
+
+TEST(NoExceptionsTests, CommitAndRules) {
+    auto zone = simparse::string("ZONE ") + simparse::commit(simparse::rep(1, simparse::digit));
+    auto record = simparse::back(zone) | simparse::string("ZONETITLE");
+
+    std::string str = "ZONE x";
+    auto it = str.begin();
+    auto r = simparse::try_parse(record, it, str.end());
+    ASSERT_FALSE(r);
+    EXPECT_TRUE(r.error().fatal);
+
+    simparse::rule<std::string::iterator, std::string, std::string::iterator> group;
+    group = simparse::back(simparse::ignore(simparse::string("(")) + group + simparse::ignore(simparse::string(")")))
+        | (simparse::rep(1, simparse::digit) + simparse::many(simparse::digit));
+    str = "((42))";
+    it = str.begin();
+    EXPECT_EQ(*simparse::try_parse(group, it, str.end()), "42");
+    str = "((42)";
+    it = str.begin();
+    EXPECT_FALSE(simparse::try_parse(group, it, str.end()));
+}
+
+TEST(NoExceptionsTests, TypedResults) {
+    auto number = simparse::map(simparse::rep(1, simparse::digit) + simparse::many(simparse::digit),
+        [](std::string s) { return static_cast<int>(s.size()); });
+    auto pair = simparse::seq_tuple(simparse::many(simparse::alphabet), simparse::character('='), number);
+
+    std::string str = "I=120";
+    auto it = str.begin();
+    auto r = simparse::try_parse(pair, it, str.end());
+    ASSERT_TRUE(r);
+    EXPECT_EQ(*r, std::make_tuple(std::string("I"), '=', 3));
+
+    std::vector<double> values(3);
+    str = "1.5, -2 3e2 x";
+    it = str.begin();
+    EXPECT_EQ(*simparse::try_parse(simparse::values_into(std::span<double>(values)), it, str.end()), 3u);
+    EXPECT_EQ(values, (std::vector<double>{1.5, -2.0, 300.0}));
+    EXPECT_FALSE(simparse::try_parse(simparse::real<double>(), ++it, str.end()));
+}
+
+TEST(NoExceptionsTests, ErrorCodes) {
+    namespace vm = simparse::vm;
+    auto nested = vm::capture(vm::lit("a") + vm::capture(vm::lit("b")));
+    auto program = vm::try_compile(nested);
+    ASSERT_FALSE(program);
+    EXPECT_STREQ(program.error().message, "simparse::vm: captures must not nest");
+    EXPECT_TRUE(vm::try_compile(vm::capture(vm::lit("a"))));
+
+    std::error_code ec;
+    simparse::mapped_file missing("/nonexistent/simparse", ec);
+    EXPECT_EQ(ec, std::errc::no_such_file_or_directory);
+    EXPECT_TRUE(missing.empty());
+}
+
+TEST(NoExceptionsTests, ThrowingInterfaceAborts) {
+    std::string str = "x";
+    auto it = str.begin();
+    EXPECT_DEATH(simparse::digit(it, str.end()), "simparse: Condition not satisfied.");
+}
\ No newline at end of file
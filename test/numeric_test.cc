@@ -0,0 +1,236 @@
+#include "simparse/numeric.hpp"
+#include <gtest/gtest.h>
+#include <list>
+#include <vector>
+
+TEST(NumericTests, Integer) {
+    std::string str = "42 -17 +8 x";
+    auto it = str.begin();
+
+    EXPECT_EQ(simparse::integer<int>()(it), 42);
+    EXPECT_EQ(it, str.begin() + 2);
+    ++it;
+    EXPECT_EQ(simparse::integer<int>()(it), -17);
+    ++it;
+    EXPECT_EQ(simparse::integer<long>()(it), 8);
+    ++it;
+#if SIMPARSE_EXCEPTIONS
+    EXPECT_THROW(simparse::integer<int>()(it), std::runtime_error);
+#endif
+    EXPECT_EQ(it, str.begin() + 10);
+}
+
+TEST(NumericTests, IntegerRange) {
+    std::string str = "300 -1";
+    auto it = str.begin();
+    EXPECT_FALSE(simparse::try_parse(simparse::integer<std::int8_t>(), it));
+    EXPECT_EQ(it, str.begin());
+    EXPECT_EQ(*simparse::try_parse(simparse::integer<std::uint16_t>(), it), 300);
+
+    ++it;
+    EXPECT_FALSE(simparse::try_parse(simparse::integer<unsigned>(), it));
+    EXPECT_EQ(it, str.begin() + 4);
+}
+
+TEST(NumericTests, Real) {
+    std::string str = "1.5 -2.25e3 +.5 7. 1.0E-05";
+    auto it = str.begin();
+    auto parser = simparse::real<double>();
+    auto space = simparse::many(simparse::whitespace);
+
+    EXPECT_DOUBLE_EQ(parser(it), 1.5);
+    space(it);
+    EXPECT_DOUBLE_EQ(parser(it), -2250.0);
+    space(it);
+    EXPECT_DOUBLE_EQ(parser(it), 0.5);
+    space(it);
+    EXPECT_DOUBLE_EQ(parser(it), 7.0);
+    space(it);
+    EXPECT_DOUBLE_EQ(parser(it), 1.0e-5);
+    EXPECT_EQ(it, str.end());
+}
+
+TEST(NumericTests, RealExponentForms) {
+    std::string str = "1.0D+03 2.5d-1 1.0-05 3.0+2 4e x";
+    auto it = str.begin();
+    auto parser = simparse::real<double>();
+    auto space = simparse::many(simparse::whitespace);
+
+    EXPECT_DOUBLE_EQ(parser(it), 1000.0);
+    space(it);
+    EXPECT_DOUBLE_EQ(parser(it), 0.25);
+    space(it);
+    EXPECT_DOUBLE_EQ(parser(it), 1.0e-5);
+    space(it);
+    EXPECT_DOUBLE_EQ(parser(it), 300.0);
+    space(it);
+    EXPECT_DOUBLE_EQ(parser(it), 4.0);
+    EXPECT_EQ(*it, 'e');
+    ++it;
+    space(it);
+    EXPECT_FALSE(simparse::try_parse(parser, it));
+    EXPECT_EQ(*it, 'x');
+}
+
+TEST(NumericTests, RealFloatBounded) {
+    const char buf[] = {'1', '.', '2', '5', 'e', '2', '9'};
+    const char* it = buf;
+    EXPECT_FLOAT_EQ(simparse::real<float>()(it, buf + 6), 125.0f);
+    EXPECT_EQ(it, buf + 6);
+
+    std::list<char> chars = {'-', '3', '.', '5', 'D', '1'};
+    auto lit = chars.begin();
+    EXPECT_DOUBLE_EQ(simparse::real<double>()(lit, chars.end()), -35.0);
+    EXPECT_EQ(lit, chars.end());
+}
+
+TEST(NumericTests, IntegerList) {
+    std::string str = " 1 22\t333\n4444 55555 666666 7777777 88888888 999999999 1234567890 -2147483648 +7";
+    std::vector<std::int32_t> values(12);
+    auto it = str.begin();
+
+    auto count = simparse::integer_list(std::span<std::int32_t>(values))(it, str.end());
+    EXPECT_EQ(count, 12u);
+    EXPECT_EQ(it, str.end());
+    EXPECT_EQ(values, (std::vector<std::int32_t>{
+        1, 22, 333, 4444, 55555, 666666, 7777777, 88888888, 999999999, 1234567890, -2147483648, 7}));
+
+    std::vector<std::int64_t> wide(2);
+    std::string big = "9223372036854775807 -9223372036854775808";
+    auto bit = big.begin();
+    simparse::integer_list(std::span<std::int64_t>(wide))(bit);
+    EXPECT_EQ(wide[0], std::numeric_limits<std::int64_t>::max());
+    EXPECT_EQ(wide[1], std::numeric_limits<std::int64_t>::min());
+}
+
+TEST(NumericTests, IntegerListErrors) {
+    std::vector<std::int32_t> values(3);
+    auto parser = simparse::integer_list(std::span<std::int32_t>(values));
+
+    std::string bad = "1 2 x";
+    auto it = bad.begin();
+    EXPECT_FALSE(simparse::try_parse(parser, it, bad.end()));
+    EXPECT_EQ(it, bad.begin() + 4);
+    EXPECT_EQ(values[1], 2);
+
+    std::string overflow = "1 2 2147483648";
+    it = overflow.begin();
+    EXPECT_FALSE(simparse::try_parse(parser, it, overflow.end()));
+    EXPECT_EQ(it, overflow.begin() + 4);
+
+    std::string truncated = "1 2 3";
+    it = truncated.begin();
+    EXPECT_FALSE(simparse::try_parse(parser, it, truncated.begin() + 4));
+}
+
+TEST(NumericTests, IntegerListMatchesScalar) {
+    std::string str;
+    std::vector<std::int64_t> expected;
+    std::uint64_t x = 1;
+    for (int i = 0; i < 500; ++i) {
+        x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+        auto v = static_cast<std::int64_t>(x >> (i % 60 + 1)) * (i % 3 == 0 ? -1 : 1);
+        expected.push_back(v);
+        str += std::to_string(v) + (i % 7 == 0 ? "\n  " : " ");
+    }
+    std::string padded = str + std::string(32, '\0');
+
+    std::vector<std::int64_t> values(expected.size());
+    const char* first = padded.data();
+    const char* it = first;
+    simparse::integer_list(std::span<std::int64_t>(values))(it, simparse::padded_end<32>(first + str.size()));
+    EXPECT_EQ(values, expected);
+
+    std::list<char> chars(str.begin(), str.end());
+    auto lit = chars.begin();
+    std::vector<std::int64_t> scalar(expected.size());
+    simparse::integer_list(std::span<std::int64_t>(scalar))(lit, chars.end());
+    EXPECT_EQ(scalar, expected);
+
+    std::vector<std::int64_t> terminated(expected.size());
+    it = str.c_str();
+    simparse::integer_list(std::span<std::int64_t>(terminated))(it);
+    EXPECT_EQ(terminated, expected);
+}
+
+TEST(NumericTests, IntegerListTerminated) {
+    // Lists followed by more data, parsed one after the other up to the NUL.
+    std::string str = "ZONE 1 22 333\nZONE 4444 55555 -666666\nZONE 000000012345678 +9 1";
+    std::vector<std::int32_t> values(3);
+    auto list = simparse::integer_list(std::span<std::int32_t>(values));
+    auto zone = simparse::string("ZONE") + simparse::ignore(list) + simparse::many(simparse::whitespace);
+    const char* it = str.c_str();
+    zone(it);
+    EXPECT_EQ(values, (std::vector<std::int32_t>{1, 22, 333}));
+    zone(it);
+    EXPECT_EQ(values, (std::vector<std::int32_t>{4444, 55555, -666666}));
+    zone(it);
+    EXPECT_EQ(values, (std::vector<std::int32_t>{12345678, 9, 1}));
+    EXPECT_EQ(*it, '\0');
+
+    std::string bad = "1 2 -";
+    it = bad.c_str();
+    EXPECT_FALSE(simparse::try_parse(list, it));
+    EXPECT_EQ(it, bad.c_str() + 4);
+    std::string short_list = "1 2  ";
+    it = short_list.c_str();
+    EXPECT_FALSE(simparse::try_parse(list, it));
+    EXPECT_EQ(it, short_list.c_str() + 5);
+}
+
+TEST(NumericTests, IntegerListLongTokens) {
+    // Twenty digits and leading zeros, on contiguous and node-based input alike.
+    std::string str = "18446744073709551615 00000000000000000000001 000 +0 18446744073709551616";
+    std::list<char> chars(str.begin(), str.end());
+    std::vector<std::uint64_t> values(4);
+    std::vector<std::uint64_t> scalar(4);
+    const std::vector<std::uint64_t> expected{std::numeric_limits<std::uint64_t>::max(), 1, 0, 0};
+
+    const char* it = str.data();
+    const char* last = str.data() + str.size();
+    auto lit = chars.begin();
+    EXPECT_TRUE(simparse::try_parse(simparse::integer_list(std::span<std::uint64_t>(values)), it, last));
+    EXPECT_TRUE(simparse::try_parse(simparse::integer_list(std::span<std::uint64_t>(scalar)), lit, chars.end()));
+    EXPECT_EQ(values, expected);
+    EXPECT_EQ(scalar, expected);
+
+    // One past the maximum overflows on both paths.
+    std::vector<std::uint64_t> one(1);
+    it = str.data() + str.rfind(' ');
+    lit = std::next(chars.begin(), static_cast<std::ptrdiff_t>(str.rfind(' ')));
+    EXPECT_FALSE(simparse::try_parse(simparse::integer_list(std::span<std::uint64_t>(one)), it, last));
+    EXPECT_FALSE(simparse::try_parse(simparse::integer_list(std::span<std::uint64_t>(one)), lit, chars.end()));
+}
+
+TEST(NumericTests, ValuesInto) {
+    std::string str = "  1.5, 2.0e1\n-3 ,4.0D-1 , 5.0-01\t6";
+    std::vector<double> values(6);
+    auto it = str.begin();
+
+    auto count = simparse::values_into(std::span<double>(values))(it, str.end());
+    EXPECT_EQ(count, 6u);
+    EXPECT_EQ(it, str.end());
+    EXPECT_EQ(values, (std::vector<double>{1.5, 20.0, -3.0, 0.4, 0.5, 6.0}));
+
+    std::vector<float> floats(3);
+    std::string text = "1 2 3";
+    const char* p = text.c_str();
+    simparse::values_into(std::span<float>(floats))(p);
+    EXPECT_EQ(floats, (std::vector<float>{1.0f, 2.0f, 3.0f}));
+}
+
+TEST(NumericTests, ValuesIntoMalformedOffset) {
+    std::string str = "1.0 2.0 x3.0 4.0";
+    std::vector<double> values(4);
+    auto it = str.begin();
+
+    auto result = simparse::try_parse(simparse::values_into(std::span<double>(values)), it, str.end());
+    EXPECT_FALSE(result);
+    EXPECT_EQ(it - str.begin(), 8);
+    EXPECT_EQ(values[1], 2.0);
+
+    std::string doubled = "1.0,,2.0";
+    it = doubled.begin();
+    EXPECT_FALSE(simparse::try_parse(simparse::values_into(std::span<double>(values.data(), 2)), it, doubled.end()));
+    EXPECT_EQ(it - doubled.begin(), 4);
+}
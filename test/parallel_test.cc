@@ -0,0 +1,127 @@
+#include "simparse/parallel.hpp"
+#include "simparse/numeric.hpp"
+#include "simparse/tecplot_corpus.hpp"
+#include <cstdlib>
+#include <span>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+TEST(ParallelTests, ManyMatchesSequential) {
+    std::string str;
+    std::vector<double> expected;
+    for (int i = 0; i < 20000; ++i) {
+        expected.push_back(i * 0.25 - 100.0);
+        str += std::to_string(expected.back());
+        str += (i % 7 == 6) ? "\n" : "  ";
+    }
+
+    simparse::parallel_options options;
+    options.chunk_size = 1000;
+    const char* it = str.data();
+    auto result = simparse::parallel_many(it, str.data() + str.size(), simparse::real<double>(), options);
+    ASSERT_TRUE(result);
+    EXPECT_EQ(*result, expected);
+    EXPECT_EQ(it, str.data() + str.size());
+}
+
+TEST(ParallelTests, ManyLineRecords) {
+    std::string str;
+    for (int i = 0; i < 5000; ++i) {
+        str += "node " + std::to_string(i) + "\n";
+    }
+
+    simparse::parallel_options options;
+    options.separators = simparse::char_class::of('\n');
+    options.boundaries = simparse::char_class::of('\n');
+    options.chunk_size = 512;
+    auto record = simparse::string("node ") + simparse::many(simparse::digit);
+    const char* it = str.data();
+    auto result = simparse::parallel_many(it, str.data() + str.size(), record, options);
+    ASSERT_TRUE(result);
+    ASSERT_EQ(result->size(), 5000u);
+    EXPECT_EQ((*result)[0], "node 0");
+    EXPECT_EQ((*result)[4999], "node 4999");
+}
+
+TEST(ParallelTests, ManyReportsFirstFailure) {
+    std::string str;
+    for (int i = 0; i < 10000; ++i) {
+        str += (i == 3000 || i == 9000) ? "x " : "1.5 ";
+    }
+
+    simparse::parallel_options options;
+    options.chunk_size = 256;
+    const char* it = str.data();
+    auto result = simparse::parallel_many(it, str.data() + str.size(), simparse::real<double>(), options);
+    EXPECT_FALSE(result);
+    EXPECT_EQ(it - str.data(), 3000 * 4);
+
+    std::string empty = " \n ";
+    it = empty.data();
+    auto none = simparse::parallel_many(it, empty.data() + empty.size(), simparse::real<double>());
+    ASSERT_TRUE(none);
+    EXPECT_TRUE(none->empty());
+}
+
+
+TEST(ParallelTests, TecplotCorpus) {
+    // SIMPARSE_TEST_CORPUS_NODES scales the generated zone, e.g. to gigabytes.
+    simparse::tecplot_options options;
+    options.variables = 5;
+    options.i = 1000;
+    options.j = 20;
+    if (const char* env = std::getenv("SIMPARSE_TEST_CORPUS_NODES")) {
+        options.i = std::strtoull(env, nullptr, 10) / options.j;
+    }
+    auto count = options.variables * options.i * options.j;
+
+    auto parse_zone = [&](const std::string& text) {
+        const char* it = text.data() + text.find('\n', text.find("ZONE")) + 1;
+        simparse::parallel_options parallel;
+        parallel.chunk_size = 1 << 14;
+        auto result = simparse::parallel_many(it, text.data() + text.size(), simparse::real<double>(), parallel);
+        EXPECT_EQ(it, text.data() + text.size());
+        return result ? std::move(*result) : std::vector<double>{};
+    };
+
+    auto point_text = simparse::make_tecplot(options);
+    EXPECT_EQ(point_text, simparse::make_tecplot(options));
+    auto point = parse_zone(point_text);
+    ASSERT_EQ(point.size(), count);
+
+    std::vector<double> expected(count);
+    const char* it = point_text.data() + point_text.find('\n', point_text.find("ZONE")) + 1;
+    ASSERT_TRUE(simparse::try_parse(simparse::values_into(std::span<double>(expected)), it));
+    EXPECT_EQ(point, expected);
+
+    options.data_packing = simparse::tecplot_options::packing::block;
+    options.values_per_line = 0;
+    auto block = parse_zone(simparse::make_tecplot(options));
+    ASSERT_EQ(block.size(), count);
+    auto nodes = options.i * options.j;
+    for (std::size_t n = 0; n < nodes; n += 997) {
+        for (std::size_t v = 0; v < options.variables; ++v) {
+            EXPECT_EQ(block[v * nodes + n], point[n * options.variables + v]);
+        }
+    }
+}
+
+TEST(ParallelTests, TecplotCorpusPrecision) {
+    // Long tokens are written whole: any precision from 17 up reads back the same values.
+    simparse::tecplot_options options;
+    options.i = 50;
+    auto values = [&](int precision, std::chars_format format) {
+        options.precision = precision;
+        options.format = format;
+        auto text = simparse::make_tecplot(options);
+        std::vector<double> result(options.variables * options.i);
+        const char* it = text.data() + text.find('\n', text.find("ZONE")) + 1;
+        EXPECT_TRUE(simparse::try_parse(simparse::values_into(std::span<double>(result)), it));
+        EXPECT_STREQ(it, "\n");
+        return result;
+    };
+    auto expected = values(17, std::chars_format::scientific);
+    EXPECT_EQ(values(120, std::chars_format::scientific), expected);
+    EXPECT_EQ(values(400, std::chars_format::fixed), expected);
+}
\ No newline at end of file
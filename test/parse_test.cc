@@ -1,4 +1,5 @@
 #include "simparse.hpp"
+#include "simparse/instrument.hpp"
 #include <gtest/gtest.h>
 
 TEST(ParseTests, AnyChar) {
@@ -17,7 +18,9 @@ TEST(ParseTests, AnyChar) {
     EXPECT_EQ(result, 'c');
     EXPECT_EQ(it, str.begin() + 3);
 
+#if SIMPARSE_EXCEPTIONS
     EXPECT_THROW(simparse::any_char(it), std::runtime_error);
+#endif
 }
 
 TEST(ParseTests, Reputation) {
@@ -29,7 +32,9 @@ TEST(ParseTests, Reputation) {
     EXPECT_EQ(result, "ab");
     EXPECT_EQ(it, str.begin() + 2);
     
+#if SIMPARSE_EXCEPTIONS
     EXPECT_THROW(parser(it), std::runtime_error);
+#endif
 }
 
 TEST(ParseTests, String) {
@@ -41,7 +46,9 @@ TEST(ParseTests, String) {
     EXPECT_EQ(result, "abc");
     EXPECT_EQ(it, str.begin() + 3);
 
+#if SIMPARSE_EXCEPTIONS
     EXPECT_THROW(parser(it), std::runtime_error);
+#endif
 }
 
 TEST(ParseTests, OrParse) {
@@ -56,7 +63,9 @@ TEST(ParseTests, OrParse) {
     result = parser(it);
     EXPECT_EQ(result, "def");
     EXPECT_EQ(it, str.end());
+#if SIMPARSE_EXCEPTIONS
     EXPECT_THROW(parser(it), std::runtime_error);
+#endif
 }
 
 TEST(ParseTests, Ignore) {
@@ -84,7 +93,9 @@ TEST(ParseTests, Back) {
     auto it = str.begin();
     auto parser = simparse::back(simparse::string("acb"));
 
+#if SIMPARSE_EXCEPTIONS
     EXPECT_THROW(parser(it), std::runtime_error);
+#endif
     EXPECT_EQ(it, str.begin());
 }
 
@@ -148,7 +159,9 @@ TEST(ParseTests, ExampleTest) {
     std::string item4 = item(it);
     EXPECT_EQ(item4, "var4");
 
+#if SIMPARSE_EXCEPTIONS
     EXPECT_THROW(item(it), std::runtime_error);
+#endif
 }
 
 TEST(ParseTests, ExampleTest2) {
@@ -190,5 +203,587 @@ TEST(ParseTests, ExampleTest2) {
     EXPECT_EQ(label3, "K");
     EXPECT_EQ(var3, "3");
 
+#if SIMPARSE_EXCEPTIONS
     EXPECT_THROW(label_parser(it), std::runtime_error);
-}
\ No newline at end of file
+#endif
+}
+
+TEST(ParseTests, TryParse) {
+    std::string str = "abc";
+    auto it = str.begin();
+    auto parser = simparse::string("ab") + simparse::digit;
+
+    auto result = simparse::try_parse(parser, it);
+    EXPECT_FALSE(result);
+    EXPECT_NE(result.error().message, nullptr);
+
+    it = str.begin();
+    auto ok = simparse::try_parse(simparse::string("ab") | simparse::string("xy"), it);
+    ASSERT_TRUE(ok);
+    EXPECT_EQ(*ok, "ab");
+    EXPECT_EQ(it, str.begin() + 2);
+}
+
+TEST(ParseTests, TryParseBack) {
+    std::string str = "abc";
+    auto it = str.begin();
+    auto parser = simparse::back(simparse::string("abd"));
+
+    auto result = parser.try_parse(it);
+    EXPECT_FALSE(result.has_value());
+    EXPECT_EQ(it, str.begin());
+}
+
+// Legacy parsers report failures by throwing.
+#if SIMPARSE_EXCEPTIONS
+TEST(ParseTests, TryParseLegacyParser) {
+    std::string str = "ab";
+    auto legacy = []<simparse::CharIterator I>(I& it) -> char {
+        if (*it != 'a') {
+            throw std::runtime_error("not a");
+        }
+        return *it++;
+    };
+    auto it = str.begin();
+
+    auto result = simparse::try_parse(legacy, it);
+    ASSERT_TRUE(result);
+    EXPECT_EQ(*result, 'a');
+    EXPECT_FALSE(simparse::try_parse(legacy, it));
+
+    it = str.begin();
+    auto parser = simparse::many(legacy) + simparse::string("b");
+    EXPECT_EQ(parser(it), "ab");
+}
+#endif
+
+TEST(ParseTests, View) {
+    std::string str = "abc123 def";
+    auto it = str.begin();
+    auto parser = simparse::view(simparse::many(simparse::alphanumeric));
+
+    std::string_view result = parser(it);
+    EXPECT_EQ(result, "abc123");
+    EXPECT_EQ(result.data(), str.data());
+    EXPECT_EQ(it, str.begin() + 6);
+
+    const char* buf = "key = value";
+    const char* p = buf;
+    auto key = simparse::view(simparse::many(simparse::alphabet));
+    auto sep = simparse::view(simparse::many(simparse::whitespace) + simparse::string("=") + simparse::many(simparse::whitespace));
+    std::string_view merged = (key + sep + key)(p);
+    EXPECT_EQ(merged, "key = value");
+    EXPECT_EQ(merged.data(), buf);
+}
+
+TEST(ParseTests, ViewConcat) {
+    std::string str = "\"var1\"";
+    auto it = str.begin();
+    auto parser = simparse::ignore(simparse::string("\""))
+        + simparse::view(simparse::many(simparse::alphanumeric))
+        + simparse::ignore(simparse::string("\""));
+
+    std::string result = parser(it);
+    EXPECT_EQ(result, "var1");
+    EXPECT_EQ(it, str.end());
+}
+
+TEST(ParseTests, ViewConcatForeign) {
+    // A view that does not point into the input is copied, not merged.
+    static constexpr std::string_view names[] = {"POINT", "BLOCK"};
+    std::string str = "PACK=B";
+    auto it = str.begin();
+    auto packing = simparse::view(simparse::string("PACK="))
+        + simparse::map(simparse::one_of_strings({"P", "B"}), [](std::size_t i) { return names[i]; });
+    EXPECT_EQ(packing(it, str.end()), "PACK=BLOCK");
+    EXPECT_EQ(it, str.end());
+
+    // A peeked view starts where the next parser starts.
+    const char* p = "ab";
+    auto twice = simparse::peek(simparse::view(simparse::string("a")))
+        + simparse::view(simparse::string("ab"));
+    EXPECT_EQ(twice(p), "aab");
+}
+
+TEST(ParseTests, BoundedInput) {
+    const char buf[] = {'a', 'b', 'c', 'd', 'e', 'f'};
+    const char* it = buf;
+    const char* end = buf + 3;
+
+    std::string result = simparse::many(simparse::any_char)(it, end);
+    EXPECT_EQ(result, "abc");
+    EXPECT_EQ(it, end);
+
+    it = buf + 1;
+    EXPECT_FALSE(simparse::try_parse(simparse::string("bcd"), it, end));
+#if SIMPARSE_EXCEPTIONS
+    EXPECT_THROW(simparse::any_char(it, end), std::runtime_error);
+#endif
+
+    std::string str = "abcdef";
+    auto sit = str.begin();
+    auto parser = simparse::string("ab") + simparse::many(simparse::alphabet);
+    EXPECT_EQ(parser(sit, str.begin() + 4), "abcd");
+    EXPECT_EQ(sit, str.begin() + 4);
+}
+
+TEST(ParseTests, PaddedInput) {
+    std::string str = "VARIABLES=X";
+    str.append(16, '\0');
+    const char* data = str.data();
+    const char* it = data;
+    auto end = simparse::padded_end<16>(data + 11);
+
+    auto parser = simparse::string("VARIABLES") + simparse::string("=") + simparse::many(simparse::alphabet);
+    EXPECT_EQ(parser(it, end), "VARIABLES=X");
+    EXPECT_EQ(it, data + 11);
+
+    it = data;
+    auto slice = simparse::padded_end<16>(data + 5);
+    EXPECT_FALSE(simparse::try_parse(simparse::string("VARIABLES"), it, slice));
+    EXPECT_EQ(it, data + 5);
+}
+
+TEST(ParseTests, ManyCharacterClass) {
+    std::string run(100, ' ');
+    run[3] = '\t';
+    run[40] = '\n';
+    for (size_t offset = 0; offset < 40; ++offset) {
+        for (size_t len : {0, 1, 15, 16, 17, 31, 32, 33, 60}) {
+            std::string str = std::string(offset, 'x') + run.substr(0, len) + "abc";
+            auto it = str.begin() + offset;
+            EXPECT_EQ(simparse::many(simparse::whitespace)(it), run.substr(0, len));
+            EXPECT_EQ(it, str.begin() + offset + len);
+
+            it = str.begin() + offset;
+            EXPECT_EQ(simparse::many(simparse::whitespace)(it, str.end() - 3), run.substr(0, len));
+            EXPECT_EQ(it, str.begin() + offset + len);
+
+            it = str.begin() + offset;
+            auto bounded = str.begin() + offset + len / 2;
+            EXPECT_EQ(simparse::many(simparse::whitespace)(it, bounded), run.substr(0, len / 2));
+            EXPECT_EQ(it, bounded);
+        }
+    }
+}
+
+TEST(ParseTests, ManyCharacterClassPadded) {
+    std::string str = "12345678901234567890abc";
+    str.append(64, '1');
+    const char* data = str.data();
+    const char* it = data;
+
+    std::string result = simparse::many(simparse::digit)(it, simparse::padded_end<64>(data + 20));
+    EXPECT_EQ(result, "12345678901234567890");
+    EXPECT_EQ(it, data + 20);
+
+    it = data;
+    std::string_view digits = simparse::view(simparse::many(simparse::digit))(it, simparse::padded_end<64>(data + 7));
+    EXPECT_EQ(digits, "1234567");
+    EXPECT_EQ(it, data + 7);
+}
+
+TEST(ParseTests, CharClass) {
+    constexpr auto hex = simparse::char_class::range('0', '9') | simparse::char_class::of("abcdefABCDEF");
+    static_assert(hex.contains('a') && hex.contains('7') && !hex.contains('g'));
+    static_assert((hex & ~simparse::char_class::range('0', '9')) == simparse::char_class::of("abcdefABCDEF"));
+    static_assert(!simparse::whitespace.cls.contains('\0'));
+    static_assert(simparse::char_ranges::from(hex)->count == 3);
+
+    std::string str = "ab 12\tc;";
+    auto it = str.begin();
+    auto parser = simparse::many(simparse::alphanumeric | simparse::whitespace);
+    EXPECT_EQ(parser(it), "ab 12\tc");
+    EXPECT_EQ(it, str.begin() + 7);
+
+    it = str.begin();
+    EXPECT_EQ(simparse::many(simparse::exclude(';'))(it), "ab 12\tc");
+    EXPECT_EQ(simparse::character(';')(it), ';');
+}
+
+TEST(ParseTests, ManyCharacterClassNibbles) {
+    const auto odd = simparse::class_parser(simparse::char_class::of("13579acegikmoqsuwy"));
+    ASSERT_FALSE(odd.ranges.has_value());
+
+    std::string run = "1357913579acegikmoqsuwy97531acegikmoqsuwy1357913579acegikmoqsuwy";
+    for (size_t len = 0; len < run.size(); ++len) {
+        std::string str = run.substr(0, len) + "b" + run;
+        auto it = str.begin();
+        EXPECT_EQ(simparse::many(odd)(it), run.substr(0, len));
+        EXPECT_EQ(it, str.begin() + len);
+
+        it = str.begin();
+        EXPECT_EQ(simparse::many(odd)(it, str.begin() + len / 2), run.substr(0, len / 2));
+    }
+}
+
+TEST(ParseTests, FirstSet) {
+    auto keyword = simparse::string("ZONE");
+    EXPECT_TRUE(simparse::first_of(keyword).chars == simparse::char_class::of('Z'));
+    EXPECT_FALSE(simparse::first_of(keyword).nullable);
+
+    auto label = simparse::many(simparse::whitespace) + simparse::alphabet;
+    EXPECT_TRUE(simparse::first_of(label).chars == (simparse::whitespace.cls | simparse::alphabet.cls));
+    EXPECT_FALSE(simparse::first_of(label).nullable);
+
+    auto custom = simparse::satisfy([](char c) { return c == 'x'; });
+    EXPECT_TRUE(simparse::first_of(custom).chars == simparse::char_class::all());
+    EXPECT_TRUE(simparse::first_of(simparse::many(custom)).nullable);
+}
+
+TEST(ParseTests, Alternation) {
+    auto keyword = simparse::alt(
+        simparse::string("TITLE"),
+        simparse::string("VARIABLES"),
+        simparse::string("ZONETYPE"),
+        simparse::string("ZONE"),
+        simparse::string("DATASETAUXDATA")
+    );
+
+    std::string str = "VARIABLES ZONE ZONETYPE TITLE";
+    auto it = str.begin();
+    EXPECT_EQ(keyword(it), "VARIABLES");
+#if SIMPARSE_EXCEPTIONS
+    EXPECT_THROW(keyword(it), std::runtime_error);
+#endif
+    ++it;
+    EXPECT_EQ(keyword(it), "ZONE");
+    ++it;
+    EXPECT_EQ(keyword(it), "ZONETYPE");
+    ++it;
+    EXPECT_EQ(keyword(it), "TITLE");
+    EXPECT_EQ(it, str.end());
+
+    std::string bad = "ZONX";
+    it = bad.begin();
+    EXPECT_FALSE(simparse::try_parse(keyword, it));
+    EXPECT_EQ(it, bad.begin());
+}
+
+TEST(ParseTests, OneOfStrings) {
+    auto keyword = simparse::one_of_strings({"TITLE", "VARIABLES", "ZONE", "ZONETYPE", "DATASETAUXDATA"});
+
+    std::string str = "ZONETYPE=ZONE VARIABLES TIT";
+    auto it = str.begin();
+    EXPECT_EQ(keyword(it), 3u);
+    EXPECT_EQ(it, str.begin() + 8);
+    ++it;
+    EXPECT_EQ(keyword(it), 2u);
+    ++it;
+    EXPECT_EQ(keyword(it), 1u);
+    ++it;
+    EXPECT_FALSE(simparse::try_parse(keyword, it));
+    EXPECT_EQ(it, str.begin() + 24);
+
+    EXPECT_TRUE(simparse::first_of(keyword).chars == simparse::char_class::of("TVZD"));
+}
+
+TEST(ParseTests, OneOfStringsCaseInsensitive) {
+    auto keyword = simparse::one_of_strings({"point", "BLOCK"}, true);
+
+    std::string str = "Point block";
+    auto it = str.begin();
+    EXPECT_EQ(keyword(it), 0u);
+    ++it;
+    EXPECT_EQ(keyword(it, str.end()), 1u);
+    EXPECT_EQ(it, str.end());
+    EXPECT_TRUE(simparse::first_of(keyword).chars.contains('p'));
+    EXPECT_TRUE(simparse::first_of(keyword).chars.contains('P'));
+}
+
+TEST(ParseTests, Commit) {
+    auto number = simparse::many(simparse::digit);
+    auto zone = simparse::string("ZONE") + simparse::commit(simparse::string(" 1"));
+    auto any_word = simparse::many(simparse::alphabet);
+
+    std::string str = "ZONE 1";
+    auto it = str.begin();
+    EXPECT_EQ((simparse::back(zone) | any_word)(it, str.end()), "ZONE 1");
+
+    std::string bad = "ZONE x";
+    it = bad.begin();
+    auto result = simparse::try_parse(simparse::back(zone) | any_word, it, bad.end());
+    ASSERT_FALSE(result);
+    EXPECT_TRUE(result.error().fatal);
+    EXPECT_EQ(it, bad.begin() + 5);
+
+    it = bad.begin();
+    EXPECT_FALSE(simparse::try_parse(simparse::alt(zone, any_word), it, bad.end()));
+    EXPECT_EQ(it, bad.begin() + 5);
+
+    it = bad.begin();
+    EXPECT_FALSE(simparse::try_parse(simparse::many(zone), it, bad.end()));
+
+    it = bad.begin();
+#if SIMPARSE_EXCEPTIONS
+    EXPECT_THROW(zone(it, bad.end()), simparse::cut_error);
+#endif
+    it = bad.begin();
+    EXPECT_TRUE(simparse::try_parse(simparse::back(simparse::string("ZONE") + number) | any_word, it, bad.end()));
+}
+
+TEST(ParseTests, CommitCutsSequence) {
+    auto number = simparse::many(simparse::digit);
+    auto zone = simparse::string("ZONE ") + simparse::commit(number) + simparse::string(";");
+    auto parser = simparse::back(zone) | simparse::string("ZONE");
+
+    // The failure after the committed parser is fatal too.
+    std::string str = "ZONE 12x";
+    auto it = str.begin();
+    auto result = simparse::try_parse(parser, it, str.end());
+    ASSERT_FALSE(result);
+    EXPECT_TRUE(result.error().fatal);
+    EXPECT_EQ(it, str.begin() + 7);
+
+    it = str.begin();
+    EXPECT_TRUE(simparse::try_parse(simparse::alt(zone, simparse::string("ZONE")), it, str.end()).error().fatal);
+    it = str.begin();
+    EXPECT_TRUE(simparse::try_parse(simparse::many(zone), it, str.end()).error().fatal);
+    it = str.begin();
+    EXPECT_TRUE(simparse::try_parse(zone, it, str.end()).error().fatal);
+
+    // Commits in nested sequences and in replayed memo entries reach the enclosing sequence.
+    auto head = simparse::seq_tuple(simparse::string("ZONE "), simparse::commit(number));
+    it = str.begin();
+    EXPECT_TRUE(simparse::try_parse(simparse::back(simparse::ignore(head) + simparse::string(";")), it, str.end()).error().fatal);
+    {
+        simparse::memo_scope scope;
+        auto memo_head = simparse::memo(simparse::string("ZONE ") + simparse::commit(number));
+        it = str.begin();
+        EXPECT_EQ(memo_head(it, str.end()), "ZONE 12");
+        it = str.begin();
+        EXPECT_TRUE(simparse::try_parse(simparse::back(memo_head + simparse::string(";")), it, str.end()).error().fatal);
+        EXPECT_EQ(scope.table().size(), 1u);
+    }
+
+    // The cut ends with its alternative: a failure after the choice backtracks as usual.
+    auto record = simparse::back((simparse::back(zone) | simparse::string("TITLE")) + simparse::string("\n"));
+    auto records = simparse::many(record);
+    str = "ZONE 1;\nTITLE\nZONE 2;x";
+    it = str.begin();
+    EXPECT_EQ(records(it, str.end()), "ZONE 1;\nTITLE\n");
+    EXPECT_EQ(it, str.begin() + 14);
+}
+
+#if SIMPARSE_EXCEPTIONS
+TEST(ParseTests, CommitLegacyParser) {
+    auto zone = simparse::string("ZONE") + simparse::commit(simparse::character('1'));
+    auto legacy = [&](std::string::iterator& it) { return zone(it); };
+
+    std::string bad = "ZONE2";
+    auto it = bad.begin();
+    auto result = simparse::try_parse(legacy, it);
+    ASSERT_FALSE(result);
+    EXPECT_TRUE(result.error().fatal);
+}
+#endif
+
+
+TEST(ParseTests, Memo) {
+    int calls = 0;
+    auto counted = [&]<simparse::CharIterator I, simparse::CharSentinel<I> S>(I& it, S end) {
+        ++calls;
+        return simparse::try_parse(simparse::many(simparse::digit), it, end);
+    };
+    auto number = simparse::memo(simparse::make_parser(counted));
+    auto parser = simparse::back(number + simparse::string("a")) | (number + simparse::string("b"));
+
+    std::string str = "123b";
+    auto it = str.begin();
+    EXPECT_EQ(parser(it, str.end()), "123b");
+    EXPECT_EQ(calls, 2);
+
+    calls = 0;
+    it = str.begin();
+    {
+        simparse::memo_scope scope;
+        EXPECT_EQ(parser(it, str.end()), "123b");
+        EXPECT_EQ(scope.table().size(), 1u);
+    }
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(it, str.end());
+
+    // Entries are kept apart by end of input and by iterator type.
+    calls = 0;
+    {
+        simparse::memo_scope scope;
+        it = str.begin();
+        EXPECT_EQ(number(it, str.end()), "123");
+        it = str.begin();
+        EXPECT_EQ(number(it, str.begin() + 1), "1");
+        EXPECT_EQ(it, str.begin() + 1);
+        const char* p = str.data();
+        EXPECT_EQ(number(p, str.data() + str.size()), "123");
+        EXPECT_EQ(p, str.data() + 3);
+    }
+    EXPECT_EQ(calls, 3);
+}
+
+
+TEST(ParseTests, Rule) {
+    using iterator = std::string::iterator;
+    simparse::rule<iterator, std::string, iterator> group;
+    group = simparse::back(simparse::ignore(simparse::string("(")) + group + simparse::ignore(simparse::string(")")))
+        | (simparse::rep(1, simparse::digit) + simparse::many(simparse::digit));
+    simparse::rule<iterator, std::string, iterator> list
+        = group + simparse::many(simparse::ignore(simparse::string(",")) + group);
+
+    std::string str = "(((42))),((7)),1";
+    auto it = str.begin();
+    EXPECT_EQ(list(it, str.end()), "4271");
+    EXPECT_EQ(it, str.end());
+
+    str = "((3)";
+    it = str.begin();
+#if SIMPARSE_EXCEPTIONS
+    EXPECT_THROW(group(it, str.end()), std::runtime_error);
+#endif
+}
+
+TEST(ParseTests, RuleUndefined) {
+    simparse::rule<const char*, std::string> later;
+    auto parser = simparse::string("a") + later;
+
+    const char* str = "ab";
+    EXPECT_FALSE(simparse::try_parse(parser, str));
+    EXPECT_TRUE(simparse::first_of(later).nullable);
+
+    str = "ab";
+    later = simparse::many(simparse::alphabet);
+    EXPECT_EQ(parser(str), "ab");
+}
+
+TEST(ParseTests, RuleStorage) {
+    using iterator = std::string::iterator;
+    auto item = simparse::back(
+        simparse::ignore(simparse::string("\""))
+        + simparse::many(simparse::alphanumeric)
+        + simparse::ignore(simparse::string("\""))
+        + simparse::ignore(
+            simparse::many(simparse::whitespace)
+            + simparse::many(simparse::string(","))
+            + simparse::many(simparse::whitespace)
+        )
+    );
+    static_assert(sizeof(simparse::class_parser) <= 48);
+
+    // The grammar of ExampleTest goes to the heap with the default capacity,
+    // and stays inline in a rule with room for it.
+    simparse::rule<iterator, std::string, iterator, 1024> inline_item = item;
+    simparse::rule<iterator, std::string, iterator> heap_item = item;
+    static_assert(sizeof(item) <= 1024 && sizeof(item) > 128);
+    static_assert(sizeof(heap_item) <= 256);
+
+    std::string str = "\"var1\", \"var2\"";
+    auto it = str.begin();
+    EXPECT_EQ(inline_item(it, str.end()), "var1");
+    EXPECT_EQ(heap_item(it, str.end()), "var2");
+    EXPECT_EQ(it, str.end());
+    heap_item = simparse::many(simparse::digit);
+}
+
+TEST(ParseTests, Seq) {
+    auto word = simparse::many(simparse::alphabet);
+    auto eq = simparse::string("=");
+    auto number = simparse::many(simparse::digit);
+
+    auto chained = word + eq + number + simparse::ignore(simparse::string(";"));
+    static_assert(std::tuple_size_v<decltype(chained.parsers)> == 4);
+
+    std::string str = "I=42;J=7;";
+    auto it = str.begin();
+    EXPECT_EQ(chained(it, str.end()), "I=42");
+    EXPECT_EQ(simparse::seq(word, eq, number)(it, str.end()), "J=7");
+    EXPECT_TRUE(simparse::first_of(chained).chars.contains('='));
+
+    it = str.begin();
+    auto fields = simparse::seq_tuple(word, simparse::character('='), number);
+    auto [name, sep, value] = fields(it, str.end());
+    EXPECT_EQ(name, "I");
+    EXPECT_EQ(sep, '=');
+    EXPECT_EQ(value, "42");
+
+    it = str.begin();
+    EXPECT_FALSE(simparse::try_parse(word + eq + simparse::string(";"), it, str.end()));
+    EXPECT_EQ(it, str.begin() + 2);
+}
+
+
+TEST(ParseTests, MapFold) {
+    struct zone_header {
+        std::string title;
+        int i;
+    };
+
+    auto number = simparse::map(simparse::rep(1, simparse::digit) + simparse::many(simparse::digit),
+        [](std::string s) { return std::stoi(s); });
+    auto header = simparse::map(
+        simparse::seq_tuple(simparse::ignore(simparse::string("ZONE T=")), simparse::many(simparse::alphabet),
+                            simparse::ignore(simparse::string(", I=")), number),
+        [](std::string, std::string title, std::string, int i) { return zone_header{std::move(title), i}; });
+
+    std::string str = "ZONE T=Wing, I=120";
+    auto it = str.begin();
+    auto zone = header(it, str.end());
+    EXPECT_EQ(zone.title, "Wing");
+    EXPECT_EQ(zone.i, 120);
+    EXPECT_EQ(it, str.end());
+
+    auto item = simparse::map(simparse::seq_tuple(number, simparse::many(simparse::whitespace)),
+        [](int value, std::string) { return value; });
+    auto sum = simparse::fold(item, 0, [](int acc, int value) { return acc + value; });
+    str = "1 20 300";
+    it = str.begin();
+    EXPECT_EQ(sum(it, str.end()), 321);
+
+    auto letters = simparse::fold(simparse::alphabet, std::vector<char>{},
+        [](std::vector<char>& acc, char c) { acc.push_back(c); });
+    str = "abc1";
+    it = str.begin();
+    EXPECT_EQ(letters(it, str.end()), (std::vector<char>{'a', 'b', 'c'}));
+    EXPECT_EQ(*it, '1');
+}
+
+TEST(ParseTests, ManyInto) {
+    std::vector<std::unique_ptr<int>> out;
+    auto boxed = simparse::map(simparse::digit, [](char c) { return std::make_unique<int>(c - '0'); });
+    auto parser = simparse::many_into(boxed, out);
+
+    std::string str = "4207x";
+    auto it = str.begin();
+    EXPECT_EQ(parser(it, str.end()), 4u);
+    ASSERT_EQ(out.size(), 4u);
+    EXPECT_EQ(*out[1], 2);
+    EXPECT_EQ(*it, 'x');
+
+    it = str.begin();
+    EXPECT_TRUE(simparse::try_skip(parser, it, str.end()));
+    EXPECT_EQ(out.size(), 8u);
+}
+
+
+#if !SIMPARSE_INSTRUMENT
+TEST(ParseTests, ProbeDisabled) {
+    // Without SIMPARSE_INSTRUMENT a probe is the parser itself.
+    auto digits = simparse::many(simparse::digit);
+    auto probed = simparse::probe("digits", digits);
+    static_assert(std::is_same_v<decltype(probed), decltype(digits)>);
+
+    std::string str = "123";
+    auto it = str.begin();
+    EXPECT_EQ(probed(it, str.end()), "123");
+    EXPECT_TRUE(simparse::probe_records().empty());
+}
+#endif
+
+#if !SIMPARSE_TRACE
+TEST(ParseTests, TraceDisabled) {
+    // Without SIMPARSE_TRACE a named rule keeps its name but records no span.
+    simparse::rule<const char*, std::string, const char*> number("number");
+    number = simparse::many(simparse::digit);
+    std::string str = "42";
+    const char* it = str.data();
+    EXPECT_EQ(number(it, str.data() + str.size()), "42");
+    EXPECT_STREQ(number.name(), "number");
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,67 @@
+#include "simparse/sax.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+enum class kind { name, zone };
+
+struct stats {
+    std::vector<std::pair<kind, std::string_view>> tokens;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+    int count = 0;
+
+    void on_token(kind k, std::string_view span) {
+        tokens.emplace_back(k, span);
+    }
+
+    void on_value(double v) {
+        min = std::min(min, v);
+        max = std::max(max, v);
+        ++count;
+    }
+};
+
+}
+
+TEST(SaxTests, TokensAndValues) {
+    stats handler;
+    auto blanks = simparse::ignore(simparse::many(simparse::whitespace));
+    auto name = simparse::sax::token(handler, kind::name, simparse::many(simparse::alphanumeric));
+    auto zone = simparse::ignore(simparse::string("ZONE "))
+        + simparse::sax::token(handler, kind::zone, simparse::many(simparse::alphabet)) + blanks;
+    auto values = simparse::many(simparse::sax::value(handler) + blanks);
+    auto file = name + blanks + simparse::many(zone + values);
+
+    std::string str = "grid ZONE A 1.5 -2 3e2\nZONE B 0.25 7";
+    auto it = str.begin();
+    EXPECT_EQ(file(it, str.end()), "");
+    EXPECT_EQ(it, str.end());
+
+    ASSERT_EQ(handler.tokens.size(), 3u);
+    EXPECT_EQ(handler.tokens[0].first, kind::name);
+    EXPECT_EQ(handler.tokens[0].second, "grid");
+    EXPECT_EQ(handler.tokens[2].second, "B");
+    EXPECT_EQ(handler.count, 5);
+    EXPECT_DOUBLE_EQ(handler.min, -2.0);
+    EXPECT_DOUBLE_EQ(handler.max, 300.0);
+}
+
+TEST(SaxTests, EventsWhenSkipped) {
+    stats handler;
+    auto values = simparse::many(simparse::sax::value(handler, simparse::integer<int>())
+        + simparse::ignore(simparse::many(simparse::whitespace)));
+
+    const char* str = "4 8 15 16 23 42";
+    const char* it = str;
+    EXPECT_TRUE(simparse::try_skip(values, it));
+    EXPECT_EQ(*it, '\0');
+    EXPECT_EQ(handler.count, 6);
+    EXPECT_DOUBLE_EQ(handler.max, 42.0);
+    EXPECT_TRUE(handler.tokens.empty());
+}
\ No newline at end of file
@@ -0,0 +1,110 @@
+#include "simparse/stream.hpp"
+#include "simparse.hpp"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fcntl.h>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+
+static_assert(simparse::CharSentinel<simparse::stream_sentinel, simparse::stream_iterator>);
+
+TEST(StreamTests, ParseWithinWindow) {
+    std::string str;
+    for (int i = 0; i < 5000; ++i) {
+        str += std::to_string(i) + " ";
+    }
+    std::istringstream in(str);
+    simparse::stream_source source(in, {.chunk_size = 64, .window = 256});
+
+    auto number = simparse::many(simparse::digit);
+    auto blank = simparse::character(' ');
+    auto it = source.begin();
+    int count = 0;
+    while (it != source.end()) {
+        EXPECT_EQ(std::stoi(number(it, source.end())), count);
+        blank(it, source.end());
+        it.commit();
+        EXPECT_LE(source.buffered(), 256u);
+        ++count;
+    }
+    EXPECT_EQ(count, 5000);
+    EXPECT_EQ(it.position(), str.size());
+}
+
+TEST(StreamTests, BacktrackIsBounded) {
+    std::string str(4096, 'a');
+    std::istringstream in(str);
+    simparse::stream_source source(in, {.chunk_size = 64, .window = 128});
+
+    auto it = source.begin();
+    auto saved = it;
+    auto result = simparse::many(simparse::alphabet)(it, source.end());
+    EXPECT_EQ(result, str);
+#if SIMPARSE_EXCEPTIONS
+    EXPECT_THROW(*saved, std::out_of_range);
+#else
+    EXPECT_DEATH(*saved, "simparse: ");
+#endif
+}
+
+TEST(StreamTests, FileDescriptor) {
+    auto path = testing::TempDir() + "simparse_stream.dat";
+    std::ofstream(path) << "key = value";
+    int fd = ::open(path.c_str(), O_RDONLY);
+    ASSERT_GE(fd, 0);
+    {
+        simparse::stream_source source(fd, {.chunk_size = 4, .window = 16});
+        auto it = source.begin();
+        auto word = simparse::many(simparse::alphabet);
+        auto sep = simparse::ignore(simparse::many(simparse::whitespace) + simparse::string("=") + simparse::many(simparse::whitespace));
+        EXPECT_EQ((word + sep + word)(it, source.end()), "keyvalue");
+        EXPECT_TRUE(it == source.end());
+    }
+    ::close(fd);
+    std::remove(path.c_str());
+}
+
+TEST(StreamTests, CommitReleasesInput) {
+    std::string str;
+    for (int i = 0; i < 2000; ++i) {
+        str += "ZONE " + std::to_string(i % 10) + "\n";
+    }
+    std::istringstream in(str);
+    simparse::stream_source source(in, {.chunk_size = 64, .window = 1 << 20});
+
+    auto zone = simparse::string("ZONE ") + simparse::commit(simparse::many(simparse::digit) + simparse::string("\n"));
+    auto it = source.begin();
+    auto result = simparse::many(zone)(it, source.end());
+    EXPECT_EQ(result, str);
+    EXPECT_LE(source.buffered(), 2 * source.chunk_size());
+}
+
+TEST(StreamTests, FailureAfterCommit) {
+    auto number = simparse::many(simparse::digit);
+    auto zone = simparse::string("ZONE ") + simparse::commit(number) + simparse::string(";");
+    auto parser = simparse::back(zone) | simparse::string("ZONE");
+
+    // The failure comes after the committed parser, past the released chunks.
+    std::istringstream in("ZONE 123456789x");
+    simparse::stream_source source(in, {.chunk_size = 4, .window = 64});
+    auto it = source.begin();
+    auto result = simparse::try_parse(parser, it, source.end());
+    ASSERT_FALSE(result);
+    EXPECT_TRUE(result.error().fatal);
+    EXPECT_EQ(it.position(), 14u);
+
+    std::string str;
+    for (int i = 0; i < 50; ++i) {
+        str += "ZONE " + std::to_string(i) + ";";
+    }
+    std::istringstream records(str + "ZONE 50x");
+    simparse::stream_source many_source(records, {.chunk_size = 4, .window = 64});
+    it = many_source.begin();
+    auto many_result = simparse::try_parse(simparse::many(parser), it, many_source.end());
+    ASSERT_FALSE(many_result);
+    EXPECT_TRUE(many_result.error().fatal);
+    EXPECT_EQ(it.position(), str.size() + 7);
+}
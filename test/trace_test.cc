@@ -0,0 +1,52 @@
+#if !defined(SIMPARSE_TRACE)
+#define SIMPARSE_TRACE 1
+#endif
+#include "simparse.hpp"
+#include "simparse/numeric.hpp"
+#include "simparse/parallel.hpp"
+#include "simparse/trace.hpp"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+TEST(TraceTests, ParallelAndRuleSpans) {
+    simparse::rule<const char*, std::string, const char*> number("number");
+    number = simparse::rep(1, simparse::digit) + simparse::many(simparse::digit);
+    EXPECT_STREQ(number.name(), "number");
+
+    std::string str;
+    for (int i = 0; i < 4000; ++i) {
+        str += std::to_string(i) + " ";
+    }
+
+    simparse::clear_trace();
+    const char* it = str.data();
+    simparse::try_parse(number, it, str.data() + str.size());
+    std::ostringstream untraced;
+    simparse::write_chrome_trace(untraced);
+    EXPECT_EQ(untraced.str().find("\"number\""), std::string::npos);
+
+    simparse::start_tracing();
+    simparse::parallel_options options;
+    options.chunk_size = 1024;
+    it = str.data();
+    auto result = simparse::parallel_many(it, str.data() + str.size(), number, options);
+    simparse::stop_tracing();
+    ASSERT_TRUE(result);
+    EXPECT_EQ(result->size(), 4000u);
+
+    std::ostringstream out;
+    simparse::write_chrome_trace(out);
+    auto json = out.str();
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0), 0u);
+    for (const char* name : {"parallel_many", "split_chunks", "parse_chunk", "stitch", "number"}) {
+        EXPECT_NE(json.find("\"name\":\"" + std::string(name) + "\""), std::string::npos) << name;
+    }
+    EXPECT_NE(json.find("\"ph\":\"X\""), std::string::npos);
+    EXPECT_EQ(json.substr(json.size() - 4), "\n]}\n");
+
+    simparse::clear_trace();
+    std::ostringstream cleared;
+    simparse::write_chrome_trace(cleared);
+    EXPECT_EQ(cleared.str().find("parallel_many"), std::string::npos);
+}
\ No newline at end of file
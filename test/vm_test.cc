@@ -0,0 +1,137 @@
+#include "simparse/vm.hpp"
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+
+namespace vm = simparse::vm;
+
+TEST(VmTests, ExampleGrammar) {
+    auto ws = vm::many(vm::cls(simparse::whitespace.cls));
+    auto label = vm::compile(vm::lit("VARIABLES") + ws + vm::lit("=") + ws);
+    auto item = vm::compile(
+        vm::lit("\"") + vm::capture(vm::many(vm::cls(simparse::alphanumeric.cls))) + vm::lit("\"")
+        + ws + vm::many(vm::lit(",")) + ws);
+
+    std::string str = "VARIABLES= \"var1\", \"var2\" ,\"var3\" , \"var4\"";
+    auto it = str.begin();
+    auto label_parser = vm::parser(label);
+    auto item_parser = vm::parser(item);
+    EXPECT_EQ(label_parser(it, str.end()), "VARIABLES= ");
+    EXPECT_EQ(it, str.begin() + 11);
+    EXPECT_EQ(item_parser(it, str.end()), "var1");
+    EXPECT_EQ(item_parser(it, str.end()), "var2");
+    EXPECT_EQ(item_parser(it, str.end()), "var3");
+    EXPECT_EQ(item_parser(it, str.end()), "var4");
+    EXPECT_EQ(it, str.end());
+#if SIMPARSE_EXCEPTIONS
+    EXPECT_THROW(item_parser(it, str.end()), std::runtime_error);
+#endif
+    EXPECT_TRUE(simparse::first_of(item_parser).chars == simparse::char_class::of('"'));
+}
+
+TEST(VmTests, ChoiceAndCut) {
+    auto digits = vm::many(vm::cls(simparse::digit.cls));
+    auto zone = vm::lit("ZONE") + vm::cut() + vm::lit(" ") + vm::capture(digits);
+    auto title = vm::lit("ZONETITLE") | vm::lit("TITLE");
+    auto record = vm::parser(vm::compile(zone | vm::capture(title)));
+
+    std::string str = "TITLE";
+    auto it = str.begin();
+    EXPECT_EQ(record(it, str.end()), "TITLE");
+
+    str = "ZONE 12";
+    it = str.begin();
+    EXPECT_EQ(record(it, str.end()), "12");
+
+    str = "ZONETITLE";
+    it = str.begin();
+    auto result = simparse::try_parse(record, it, str.end());
+    ASSERT_FALSE(result);
+    EXPECT_TRUE(result.error().fatal);
+    EXPECT_EQ(it, str.begin() + 4);
+
+    auto optional = vm::parser(vm::compile(vm::optional(vm::lit("-")) + vm::many(vm::lit("ab") | vm::lit(""))));
+    str = "-abab";
+    it = str.begin();
+    EXPECT_EQ(optional(it, str.end()), "-abab");
+
+#if SIMPARSE_EXCEPTIONS
+    EXPECT_THROW(vm::compile(vm::capture(vm::capture(digits))), std::invalid_argument);
+#endif
+}
+
+TEST(VmTests, Sentinels) {
+    auto word = vm::parser(vm::compile(vm::many(vm::cls(simparse::alphabet.cls))));
+    std::string str = "abc def";
+
+    const char* it = str.data();
+    char* end = str.data() + 2;
+    EXPECT_EQ(word(it, end), "ab");
+    EXPECT_EQ(it, str.data() + 2);
+
+    it = str.data();
+    EXPECT_EQ(word(it), "abc");
+
+    it = str.data();
+    EXPECT_EQ(word(it, simparse::padded_end<1>(it + 1)), "a");
+
+    // Terminated input is checked while matching: neither literals nor classes
+    // that contain the NUL character run past it.
+    auto keyword = vm::parser(vm::compile(vm::lit("abc def") | vm::lit("ab")));
+    str = "abc de";
+    it = str.c_str();
+    EXPECT_EQ(keyword(it), "ab");
+    auto other = vm::parser(vm::compile(vm::many(vm::cls(~simparse::char_class::of('x'))) + vm::many(vm::cls(~simparse::char_class::of('y')) + vm::lit("!"))));
+    it = str.c_str();
+    EXPECT_EQ(other(it), "abc de");
+    EXPECT_EQ(it, str.c_str() + str.size());
+
+    auto item = vm::parser(vm::compile(vm::capture(vm::cls(simparse::digit.cls) + vm::many(vm::cls(simparse::digit.cls))) + vm::optional(vm::lit(","))));
+    std::string list = "1,22,333";
+    it = list.c_str();
+    EXPECT_EQ(simparse::many(item)(it), "122333");
+    EXPECT_EQ(it, list.c_str() + list.size());
+}
+
+TEST(VmTests, CutKeepsEnclosingEntries) {
+    // The cut runs inside a choice and is followed by a loop: both still pop their own entries.
+    auto ones = vm::many(vm::lit("1"));
+    auto zone = vm::lit("ZONE") + vm::cut() + vm::lit(" ") + vm::capture(ones);
+    auto record = vm::parser(vm::compile(vm::many((zone | vm::capture(vm::lit("TITLE"))) + vm::lit(";"))));
+
+    std::string str = "ZONE 11;TITLE;ZONE 1;";
+    auto it = str.begin();
+    EXPECT_EQ(record(it, str.end()), "11TITLE1");
+    EXPECT_EQ(it, str.end());
+
+    // A failure after the cut falls back neither to "TITLE" nor out of the loop.
+    str = "TITLE;ZONEx;";
+    it = str.begin();
+    auto result = simparse::try_parse(record, it, str.end());
+    ASSERT_FALSE(result);
+    EXPECT_TRUE(result.error().fatal);
+    EXPECT_EQ(it, str.begin() + 10);
+
+    // The cut ends with its alternative: the missing ';' only ends the loop.
+    str = "ZONE 1x";
+    it = str.begin();
+    EXPECT_EQ(record(it, str.end()), "");
+    EXPECT_EQ(it, str.begin());
+
+    // Loops entered after the cut still backtrack normally.
+    auto tail = vm::parser(vm::compile(vm::lit("A") + vm::cut() + vm::many(vm::lit("BC")) + vm::lit("B")));
+    str = "ABCBCB";
+    it = str.begin();
+    EXPECT_EQ(tail(it, str.end()), "ABCBCB");
+
+    // A cut in the last alternative also ends with it, as in simparse::commit.
+    auto last = vm::parser(vm::compile(((vm::lit("A") | (vm::lit("B") + vm::cut() + vm::lit("C"))) + vm::lit("D")) | vm::lit("BCE")));
+    str = "BCE";
+    it = str.begin();
+    EXPECT_EQ(last(it, str.end()), "BCE");
+    str = "BX";
+    it = str.begin();
+    auto cut_result = simparse::try_parse(last, it, str.end());
+    ASSERT_FALSE(cut_result);
+    EXPECT_TRUE(cut_result.error().fatal);
+}
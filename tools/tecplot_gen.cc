@@ -0,0 +1,104 @@
+#include "simparse/tecplot_corpus.hpp"
+#include <charconv>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+namespace {
+
+void usage(std::ostream& out) {
+    out << "usage: simparse_tecplot_gen [options] [-o FILE]\n"
+           "Writes a deterministic Tecplot ASCII file (stdout by default).\n"
+           "  --vars N         number of variables (4)\n"
+           "  --zones N        number of zones (1)\n"
+           "  --i N --j N --k N zone sizes (64, 1, 1)\n"
+           "  --block          BLOCK packing instead of POINT\n"
+           "  --format F       fixed, scientific or general (scientific)\n"
+           "  --precision N    digits after the point (6, at most 1074)\n"
+           "  --per-line N     values per line, 0 for no limit (5)\n"
+           "  --seed N         seed of the values (1)\n";
+}
+
+bool parse_number(std::string_view text, std::uint64_t& value) {
+    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return ec == std::errc{} && end == text.data() + text.size();
+}
+
+}
+
+int main(int argc, char** argv) {
+    simparse::tecplot_options options;
+    std::string path;
+    for (int a = 1; a < argc; ++a) {
+        std::string_view arg = argv[a];
+        if (arg == "--help" || arg == "-h") {
+            usage(std::cout);
+            return 0;
+        }
+        if (arg == "--block") {
+            options.data_packing = simparse::tecplot_options::packing::block;
+            continue;
+        }
+        if (a + 1 == argc) {
+            usage(std::cerr);
+            return 2;
+        }
+        std::string_view value = argv[++a];
+        std::uint64_t n = 0;
+        bool ok = true;
+        if (arg == "-o") {
+            path = value;
+        } else if (arg == "--format") {
+            if (value == "fixed") {
+                options.format = std::chars_format::fixed;
+            } else if (value == "scientific") {
+                options.format = std::chars_format::scientific;
+            } else if (value == "general") {
+                options.format = std::chars_format::general;
+            } else {
+                ok = false;
+            }
+        } else if ((ok = parse_number(value, n))) {
+            if (arg == "--vars") {
+                options.variables = n;
+            } else if (arg == "--zones") {
+                options.zones = n;
+            } else if (arg == "--i") {
+                options.i = n;
+            } else if (arg == "--j") {
+                options.j = n;
+            } else if (arg == "--k") {
+                options.k = n;
+            } else if (arg == "--precision") {
+                // 1074 digits print every double exactly; more only adds zeros.
+                ok = n <= 1074;
+                options.precision = static_cast<int>(n);
+            } else if (arg == "--per-line") {
+                options.values_per_line = n;
+            } else if (arg == "--seed") {
+                options.seed = n;
+            } else {
+                ok = false;
+            }
+        }
+        if (!ok) {
+            std::cerr << "simparse_tecplot_gen: invalid option " << arg << ' ' << value << '\n';
+            usage(std::cerr);
+            return 2;
+        }
+    }
+
+    if (path.empty()) {
+        simparse::write_tecplot(std::cout, options);
+        return std::cout ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        std::cerr << "simparse_tecplot_gen: cannot open " << path << '\n';
+        return EXIT_FAILURE;
+    }
+    simparse::write_tecplot(out, options);
+    return out ? EXIT_SUCCESS : EXIT_FAILURE;
+}